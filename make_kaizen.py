@@ -10,7 +10,7 @@ def collect_main_header_files(dirs):
     header_files = []
     alpha_header = None # separate out the alpha.h file
     for dir in dirs:
-        for filename in os.listdir(dir):
+        for filename in sorted(os.listdir(dir)):
             if filename.endswith('.h'):
                 file_path = os.path.join(dir, filename)
                 if filename == 'alpha.h' and dir.endswith('zen/datas'):
@@ -22,7 +22,7 @@ def collect_main_header_files(dirs):
 def collect_composite_headers(zen_composites):
     header_files = []
     composite_includes = set()
-    for filename in os.listdir(zen_composites):
+    for filename in sorted(os.listdir(zen_composites)):
         if filename.endswith('.h'):
             header_file = os.path.join(zen_composites, filename)
             include_directives, _ = parse_header_file(header_file)
@@ -30,6 +30,33 @@ def collect_composite_headers(zen_composites):
             header_files.append(header_file)
     return header_files, composite_includes
 
+# Lists the Kaizen-internal headers (like #include "timer.h") that a header file depends on
+def internal_includes(header_file):
+    includes = []
+    with open(header_file, 'r') as input_file:
+        for line in input_file:
+            match = re.match(r'#include\s+"(.*)"', line)
+            if match:
+                includes.append(os.path.normpath(os.path.join(os.path.dirname(header_file), match.group(1))))
+    return includes
+
+# Keeps the alphabetical order, except that any header comes after the internal headers it
+# #includes, so that one header can build on another regardless of how both are named
+def order_by_dependencies(header_files):
+    ordered = []
+    visited = set()
+    def visit(header_file):
+        if header_file in visited:
+            return
+        visited.add(header_file)
+        for dependency in internal_includes(header_file):
+            if dependency in header_files:
+                visit(dependency)
+        ordered.append(header_file)
+    for header_file in header_files:
+        visit(header_file)
+    return ordered
+
 # Separates license, include directives and code
 def parse_header_file(header_file):
     include_directives = set()
@@ -37,6 +64,9 @@ def parse_header_file(header_file):
     with open(header_file, 'r') as input_file:
         lines = input_file.readlines()
         skipping_license = True # to skip license comments at the top of files
+        namespace_found  = False
+        conditional      = [] # a platform-specific #if ... #endif block before namespace zen
+        depth            = 0
         for line in lines:
             if skipping_license:
                 if line.strip().startswith('//'):
@@ -46,7 +76,26 @@ def parse_header_file(header_file):
 
             if PRAGMA_ONCE in line:
                 continue
-            
+
+            if "namespace zen {" in line:
+                namespace_found = True
+
+            # Conditional blocks with #includes (like system headers for one platform only) go to
+            # the top along with the other #includes so that they don't end up inside namespace zen
+            if not namespace_found and (depth or re.match(r'#\s*if', line)):
+                conditional.append(line)
+                if re.match(r'#\s*if', line):
+                    depth += 1
+                elif re.match(r'#\s*endif', line):
+                    depth -= 1
+                if depth == 0:
+                    if any(re.match(r'#\s*include\s+[<]', l) for l in conditional):
+                        include_directives.add(''.join(conditional).rstrip('\n'))
+                    else:
+                        code_content.extend(conditional)
+                    conditional = []
+                continue
+
             # If line #includes any non-standard C++ headers (like Kaizen-internal), skip it
             if re.match(r'#include\s+"(.*)"', line):
                 continue # skip non-standard headers
@@ -162,6 +211,7 @@ if __name__ == '__main__':
     license_file = os.path.join(project_dir, 'LICENSE.txt')
 
     header_files, alpha_header = collect_main_header_files([zen_datas, zen_functions])
+    header_files = order_by_dependencies(header_files)
     composite_headers, composite_includes = collect_composite_headers(zen_composites)
     
     license_text = read_license(license_file)
@@ -171,7 +221,8 @@ if __name__ == '__main__':
 
     # Process 'alpha.h' separately and ensure its content is added first
     if alpha_header:
-        _, alpha_content = parse_header_file(alpha_header)
+        alpha_includes, alpha_content = parse_header_file(alpha_header)
+        all_include_directives.update(alpha_includes)
         all_code_content.extend(alpha_content) # ensure alpha.h content is first
     
     # Process regular headers
@@ -55,16 +55,36 @@ int main(int argc, char* argv[])
 	// Since the order of these tests doesn't matter, their
 	// calls are listed in descending length for aesthetics
 	main_test_cmd_args(argc, argv);
+	main_test_indexed_priority_queue();
+	main_test_concurrent_hash_map();
 	main_test_unordered_multiset();
 	main_test_unordered_multimap();
 	main_test_priority_queue();
 	main_test_unordered_set();
 	main_test_unordered_map();
+	main_test_flat_hash_map();
+	main_test_flat_hash_set();
+	main_test_perf_counters();
+	main_test_flat_multimap();
+	main_test_small_vector();
 	main_test_forward_list();
+	main_test_log_sampling();
+	main_test_log_deferred();
+	main_test_ring_buffer();
+	main_test_spsc_queue();
+	main_test_mpmc_queue();
+	main_test_ring_queue();
+	main_test_histogram();
+	main_test_parallel();
+	main_test_profiler();
 	main_test_multiset();
 	main_test_multimap();
+	main_test_flat_map();
+	main_test_flat_set();
     main_test_version();
+	main_test_logger();
 	main_test_string();
+	main_test_reduce();
 	main_test_vector();
 	main_test_ifile();
 	main_test_array();
@@ -75,6 +95,7 @@ int main(int argc, char* argv[])
 	main_test_timer();
 	main_test_point();
 	main_test_list();
+	main_test_rng();
 	main_test_map();
 	main_test_set();
 	main_test_in();
@@ -24,13 +24,28 @@
 
 // Since the order of these #includes doesn't matter,
 // they're sorted in descending length for aesthetics
+#include "tests/test_indexed_priority_queue.h"
+#include "tests/test_concurrent_hash_map.h"
 #include "tests/test_unordered_set.h"
 #include "tests/test_unordered_map.h"
+#include "tests/test_flat_hash_map.h"
 #include "tests/test_uncompilable.h"
+#include "tests/test_perf_counters.h"
 #include "tests/test_forward_list.h"
+#include "tests/test_concurrent_queue.h"
+#include "tests/test_small_vector.h"
+#include "tests/test_log_sampling.h"
+#include "tests/test_log_deferred.h"
+#include "tests/test_ring_buffer.h"
+#include "tests/test_histogram.h"
 #include "tests/test_cmd_args.h"
+#include "tests/test_parallel.h"
+#include "tests/test_profiler.h"
+#include "tests/test_flat_map.h"
 #include "tests/test_version.h"
+#include "tests/test_logger.h"
 #include "tests/test_string.h"
+#include "tests/test_reduce.h"
 #include "tests/test_vector.h"
 #include "tests/test_ifile.h"
 #include "tests/test_array.h"
@@ -43,6 +58,7 @@
 #include "tests/test_list.h"
 #include "tests/test_cloc.h"
 #include "tests/test_set.h"
+#include "tests/test_rng.h"
 #include "tests/test_map.h"
 #include "tests/test_in.h"
 
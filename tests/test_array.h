@@ -25,6 +25,8 @@ void main_test_array()
 
     ZEN_EXPECT( a.contains(5));
     ZEN_EXPECT(!a.contains(7));
+    ZEN_EXPECT( a.contains_any({ 7, 4 }) && !a.contains_any({ 0, 6 }));
+    ZEN_EXPECT( a.index_of(3) == 2 && !a.index_of(0) && a.count(5) == 1);
     ZEN_EXPECT(zen::is_empty(a) == a.is_empty());
 
     test_array_of_strings();
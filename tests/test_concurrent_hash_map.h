@@ -0,0 +1,116 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+void test_concurrent_hash_map_threads()
+{
+    BEGIN_SUBTEST;
+    zen::concurrent_hash_map<int, long long> m(8);
+    const int threads = 4, keys = 100, rounds = 2'000;
+
+    // Each writer bumps its own run of keys, in order, round after round: in a consistent
+    // snapshot no key of a run is ahead of the ones before it, nor more than a round behind
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::thread reader([&] {
+        while (!done) {
+            zen::vector<long long> counts(threads * keys, 0);
+            m.for_each([&](const auto& item) { counts[item.first] = item.second; });
+            for (int t = 0; t < threads; ++t) {
+                const long long* run = &counts[t * keys];
+                for (int k = 1; k < keys; ++k)
+                    if (run[k] > run[k - 1] || run[0] - run[k] > 1)
+                        consistent = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+        writers.emplace_back([&, t] {
+            for (int r = 0; r < rounds; ++r)
+                for (int k = t * keys; k < (t + 1) * keys; ++k)
+                    m.upsert(k, [](long long& n) { ++n; });
+        });
+    for (auto& w : writers)
+        w.join();
+    done = true;
+    reader.join();
+
+    bool all_counted = true;
+    for (int k = 0; k < threads * keys; ++k)
+        all_counted &= m.find(k) == rounds;
+    ZEN_EXPECT(all_counted && consistent);
+    ZEN_EXPECT(m.size() == static_cast<std::size_t>(threads * keys));
+
+    // Erasing from several threads at once, each its own share of keys
+    std::vector<std::thread> erasers;
+    for (int t = 0; t < threads; ++t)
+        erasers.emplace_back([&, t] { m.erase_if([&](const auto& item) { return item.first % threads == t; }); });
+    for (auto& e : erasers)
+        e.join();
+    ZEN_EXPECT(m.is_empty());
+}
+
+void main_test_concurrent_hash_map()
+{
+    BEGIN_TEST;
+
+    zen::concurrent_hash_map<zen::string, int, zen::string_hash> m(5);
+    ZEN_EXPECT(m.shard_count() == 8 && m.is_empty());
+
+    const bool inserted = m.insert("a", 1);
+    const bool again    = m.insert("a", 2);
+    ZEN_EXPECT(inserted && !again && m.find("a") == 1);
+
+    const bool assigned = m.insert_or_assign("a", 3);
+    ZEN_EXPECT(!assigned && m.find("a") == 3);
+
+    const bool added = m.upsert("b", [](int& n) { n += 10; });
+    m.upsert("b", [](int& n) { n += 10; });
+    ZEN_EXPECT(added && m.find("b") == 20);
+    ZEN_EXPECT(!m.find("c").has_value() && !m.contains("c") && m.contains("b"));
+
+    int seen = 0;
+    const bool visited = m.visit("b", [&](const int& n) { seen = n; });
+    const bool missing = m.visit("c", [&](const int&) { seen = -1; });
+    ZEN_EXPECT(visited && !missing && seen == 20);
+
+    for (int i = 0; i < 100; ++i)
+        m.insert(std::to_string(i), i);
+    ZEN_EXPECT(m.size() == 102);
+
+    // snapshot() is an ordinary zen::unordered_map
+    const auto copy = m.snapshot();
+    ZEN_EXPECT(copy.size() == 102 && copy.at("a") == 3 && copy.at("99") == 99);
+
+    const auto odd = m.erase_if([](const auto& item) { return item.second % 2 == 1; });
+    ZEN_EXPECT(odd == 51); // 1, 3, ..., 99 and "a"
+
+    int sum = 0;
+    m.for_each([&](const auto& item) { sum += item.second; });
+    ZEN_EXPECT(sum == 2450 + 20); // 0 + 2 + ... + 98, and "b"
+
+    const bool erased = m.erase("b");
+    const bool twice  = m.erase("b");
+    ZEN_EXPECT(erased && !twice && m.size() == 50);
+
+    m.clear();
+    ZEN_EXPECT(m.is_empty() && copy.size() == 102);
+
+    zen::concurrent_hash_map<int, int> init = { { 1, 10 }, { 2, 20 }, { 1, 30 } };
+    ZEN_EXPECT(init.size() == 2 && init.find(1) == 10);
+
+    // With a plain mutex, reads lock their shard exclusively but work the same
+    zen::basic_concurrent_hash_map<std::mutex, int, int> plain(2);
+    plain.upsert(7, [](int& n) { n = 70; });
+    int plain_sum = 0;
+    plain.for_each([&](const auto& item) { plain_sum += item.second; });
+    ZEN_EXPECT(plain.find(7) == 70 && plain.contains(7) && plain_sum == 70);
+
+    test_concurrent_hash_map_threads();
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <atomic>
+#include <thread>
+
+void test_spsc_queue_threads()
+{
+    BEGIN_SUBTEST;
+    // A small queue, so the producer keeps finding it full and the consumer empty
+    zen::spsc_queue<int> q(16);
+    const int N = 100'000;
+
+    // size() seen from a third thread stays within the capacity throughout
+    std::atomic<bool> done{false};
+    std::atomic<bool> sane{true};
+    std::thread observer([&] {
+        while (!done)
+            if (q.size() > q.capacity())
+                sane = false;
+    });
+
+    std::thread producer([&] {
+        int batch[7];
+        int i = 0;
+        while (i < N) {
+            if (i % 3 == 0) { // alternate single and batched pushes
+                q.wait_push(i++);
+                continue;
+            }
+            int k = 0;
+            for (; k < 7 && i + k < N; ++k)
+                batch[k] = i + k;
+            i += static_cast<int>(q.push_n(batch, static_cast<std::size_t>(k)));
+        }
+    });
+
+    bool in_order = true;
+    int next = 0;
+    int batch[5];
+    while (next < N) {
+        if (next % 2 == 0) {
+            int x;
+            q.wait_pop(x);
+            in_order &= x == next++;
+        } else {
+            const auto k = q.pop_n(batch, 5);
+            for (std::size_t j = 0; j < k; ++j)
+                in_order &= batch[j] == next++;
+        }
+    }
+    producer.join();
+    done = true;
+    observer.join();
+
+    ZEN_EXPECT(in_order && sane);
+    ZEN_EXPECT(q.is_empty());
+}
+
+void test_mpmc_queue_threads()
+{
+    BEGIN_SUBTEST;
+    zen::mpmc_queue<long long> q(64);
+    const int producers = 4, consumers = 3, per_producer = 20'000;
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; ++p)
+        pool.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i)
+                q.wait_push(static_cast<long long>(p) * per_producer + i);
+        });
+
+    const int total = producers * per_producer;
+    for (int c = 0; c < consumers; ++c)
+        pool.emplace_back([&, c] {
+            long long local = 0;
+            for (int i = c; i < total; i += consumers) {
+                long long x;
+                if (i % 2) {
+                    q.wait_pop(x);
+                } else {
+                    while (!q.try_pop(x))
+                        std::this_thread::yield();
+                }
+                local += x;
+                ++popped;
+            }
+            sum += local;
+        });
+
+    for (auto& t : pool)
+        t.join();
+
+    const long long expected = static_cast<long long>(total) * (total - 1) / 2;
+    ZEN_EXPECT(popped == total);
+    ZEN_EXPECT(sum == expected); // every element exactly once
+    ZEN_EXPECT(q.is_empty());
+}
+
+void main_test_spsc_queue()
+{
+    BEGIN_TEST;
+
+    zen::spsc_queue<zen::string> q(5);
+    ZEN_EXPECT(q.capacity() == 8 && q.is_empty());
+
+    for (int i = 0; i < 8; ++i)
+        q.try_push(std::to_string(i));
+    const bool pushed = q.try_push("full");
+    ZEN_EXPECT(!pushed && q.size() == 8);
+
+    zen::string s;
+    const bool popped = q.try_pop(s);
+    ZEN_EXPECT(popped && s == "0");
+
+    zen::string out[10];
+    const auto n = q.pop_n(out, 10);
+    ZEN_EXPECT(n == 7 && out[0] == "1" && out[6] == "7");
+    const bool none = q.try_pop(s);
+    ZEN_EXPECT(!none);
+
+    // Batches wrap around the end of the buffer and stop when it's full
+    const zen::string words[] = { "a", "b", "c", "d", "e", "f", "g", "h", "i" };
+    const auto k = q.push_n(words, 9);
+    ZEN_EXPECT(k == 8 && q.size() == 8);
+    q.try_pop(s);
+    ZEN_EXPECT(s == "a");
+
+    // Elements left in the queue are destroyed with it (checked under sanitizers)
+    zen::spsc_queue<zen::string> left(4);
+    left.try_emplace(100, 'x');
+
+    try {
+        zen::spsc_queue<int> none(0);
+        ZEN_EXPECT(false);
+    } catch (const std::invalid_argument& e) {
+        ZEN_EXPECT(zen::string(e.what()) == "QUEUE CAPACITY MUST BE POSITIVE");
+    }
+
+    test_spsc_queue_threads();
+}
+
+void main_test_mpmc_queue()
+{
+    BEGIN_TEST;
+
+    zen::mpmc_queue<zen::string> q(3);
+    ZEN_EXPECT(q.capacity() == 4 && q.is_empty());
+
+    // Around the buffer a few times: the sequence numbers move on a lap each time
+    bool in_order = true;
+    for (int i = 0; i < 20; ++i) {
+        q.try_push(std::to_string(i));
+        if (q.size() == 3) {
+            zen::string s;
+            q.try_pop(s);
+            in_order &= s == std::to_string(i - 2);
+        }
+    }
+    ZEN_EXPECT(in_order && q.size() == 2);
+
+    q.try_emplace(3, 'z');
+    q.try_push("last");
+    const bool pushed = q.try_push("full");
+    ZEN_EXPECT(!pushed && q.size() == 4);
+
+    zen::string s;
+    for (int i = 0; i < 4; ++i)
+        q.wait_pop(s);
+    ZEN_EXPECT(s == "last" && q.is_empty());
+    const bool popped = q.try_pop(s);
+    ZEN_EXPECT(!popped);
+
+    zen::mpmc_queue<zen::string> left(4);
+    left.try_emplace(100, 'x');
+
+    test_mpmc_queue_threads();
+}
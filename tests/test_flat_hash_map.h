@@ -0,0 +1,114 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include "../internal.h"
+
+// Checks a flat_hash_map against std::unordered_map through random inserts, lookups and erasures
+void test_flat_hash_map_against_std()
+{
+    BEGIN_SUBTEST;
+    zen::flat_hash_map<int, int> flat;
+    std::unordered_map<int, int> node;
+    zen::rng r(42);
+
+    bool same = true;
+    for (int i = 0; i < 200'000; ++i) {
+        const int key = r.between(0, 5'000);
+        switch (r.below(4)) {
+            case 0:  flat[key] = i; node[key] = i; break;
+            case 1:  same &= flat.erase(key) == node.erase(key); break;
+            case 2:  same &= flat.insert({ key, i }).second == node.insert({ key, i }).second; break;
+            default: same &= flat.contains(key) == (node.count(key) == 1); break;
+        }
+    }
+    ZEN_EXPECT(same);
+    ZEN_EXPECT(flat.size() == node.size());
+    ZEN_EXPECT(std::all_of(node.begin(), node.end(), [&flat](const auto& kv) { return flat.at(kv.first) == kv.second; }));
+    ZEN_EXPECT(std::distance(flat.begin(), flat.end()) == static_cast<std::ptrdiff_t>(node.size()));
+    ZEN_EXPECT(flat.load_factor() <= flat.max_load_factor());
+}
+
+void test_flat_hash_map_of_strings()
+{
+    BEGIN_SUBTEST;
+    zen::flat_hash_map<zen::string, int, zen::string_hash> x = { {"1", 1}, {"1", 1}, {"2", 2}, {"3", 3}, {"4", 4} };
+    x.insert({ "0", 0 });
+
+    ZEN_EXPECT(x.contains("0") && x.size() == 5);
+    ZEN_EXPECT(zen::is_empty(x) == x.is_empty());
+
+    // Long keys survive growing and rehashing
+    for (int i = 0; i < 1000; ++i)
+        x.try_emplace(zen::string("a key too long for the small string buffer #" + std::to_string(i)), i);
+    ZEN_EXPECT(x.size() == 1005 && x.at("a key too long for the small string buffer #999") == 999);
+
+    x.insert_or_assign("0", 10);
+    ZEN_EXPECT(x["0"] == 10);
+
+    zen::flat_hash_map<zen::string, int, zen::string_hash> copy = x;
+    ZEN_EXPECT(copy == x);
+    copy.erase("0");
+    ZEN_EXPECT(copy != x && copy.size() == 1004);
+
+    for (auto it = copy.begin(); it != copy.end(); ) // erasing while iterating
+        it = it->second % 2 ? copy.erase(it) : std::next(it);
+    ZEN_EXPECT(copy.size() == 502 && copy.count("3") == 0 && copy.count("2") == 1);
+
+    bool threw = false;
+    try {
+        (void)copy.at("missing");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw);
+
+    copy.clear();
+    ZEN_EXPECT(copy.is_empty() && copy.begin() == copy.end() && !copy.contains("2"));
+}
+
+void main_test_flat_hash_map()
+{
+    BEGIN_TEST;
+
+    zen::flat_hash_map<int, zen::string> x = { {1, "1"}, {2, "2"}, {3, "3"}, {4, "4"} };
+    x.insert({0, "0"});
+
+    ZEN_EXPECT(x.contains(0));
+    ZEN_EXPECT(zen::is_empty(x) == x.is_empty());
+    ZEN_EXPECT(silent_print(zen::flat_hash_map<int, int>{ {7, 8} }) == "[[7, 8]]");
+
+    // The switch between the node-based and the flat map
+    ZEN_EXPECT((std::is_same_v<zen::basic_hash_map<true,  int, int>, zen::flat_hash_map<int, int>>));
+    ZEN_EXPECT((std::is_same_v<zen::basic_hash_map<false, int, int>, zen::unordered_map<int, int>>));
+
+    test_flat_hash_map_against_std();
+    test_flat_hash_map_of_strings();
+}
+
+void main_test_flat_hash_set()
+{
+    BEGIN_TEST;
+
+    zen::flat_hash_set<int> x = { 1, 2, 3, 4 };
+    x.insert(0);
+    x.insert(0);
+
+    ZEN_EXPECT(x.contains(0) && x.size() == 5);
+    ZEN_EXPECT(zen::is_empty(x) == x.is_empty());
+
+    zen::flat_hash_set<int> y;
+    y.reserve(1000);
+    const auto capacity = y.capacity();
+    for (int i = 0; i < 1000; ++i)
+        y.insert(i * 128); // multiples of 128 collide without mixing the hash
+    ZEN_EXPECT(y.capacity() == capacity && y.size() == 1000 && y.contains(127'872) && !y.contains(64));
+
+    for (int i = 0; i < 1000; ++i) // many tombstones, then rehashing in place
+        if (y.erase(i * 128) == 1)
+            y.insert(i * 128 + 1);
+    ZEN_EXPECT(y.size() == 1000 && y.contains(1) && !y.contains(0) && y.capacity() == capacity);
+
+    ZEN_EXPECT((std::is_same_v<zen::basic_hash_set<true, int>, zen::flat_hash_set<int>>));
+    ZEN_EXPECT(x != y && x == zen::flat_hash_set<int>({ 4, 3, 2, 1, 0 }));
+}
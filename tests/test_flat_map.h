@@ -0,0 +1,132 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include "../internal.h"
+
+// Checks bulk and single insertions, lookups and erasures against std::map
+void test_flat_map_against_std()
+{
+    BEGIN_SUBTEST;
+    zen::rng r(7);
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 5'000; ++i)
+        batch.emplace_back(r.between(0, 3'000), i);
+
+    zen::flat_map<int, int> flat(batch.begin(), batch.end());
+    std::map<int, int> tree;
+    for (const auto& kv : batch)
+        tree.insert(kv); // the first value of a key wins, as with the bulk insert
+
+    bool same = true;
+    for (int i = 0; i < 20'000; ++i) {
+        const int key = r.between(-10, 3'010);
+        switch (r.below(4)) {
+            case 0:  same &= flat.insert({ key, i }).second == tree.insert({ key, i }).second; break;
+            case 1:  same &= flat.erase(key) == tree.erase(key); break;
+            case 2:  same &= (flat.lower_bound(key) == flat.end()) == (tree.lower_bound(key) == tree.end()); break;
+            default: same &= flat.contains(key) == (tree.count(key) == 1); break;
+        }
+    }
+    ZEN_EXPECT(same);
+    ZEN_EXPECT(flat.size() == tree.size());
+    ZEN_EXPECT(std::equal(flat.begin(), flat.end(), tree.begin(), tree.end(), [](const auto& a, const auto& b) {
+        return a.first == b.first && a.second == b.second;
+    }));
+
+    // A second bulk insert merges into what's there
+    const auto before = flat.size();
+    std::vector<std::pair<int, int>> more = { { -100, 0 }, { 5'000, 0 }, { 5'000, 1 } };
+    flat.insert(more.begin(), more.end());
+    ZEN_EXPECT(flat.size() == before + 2 && flat.at(5'000) == 0 && std::is_sorted(flat.keys().begin(), flat.keys().end()));
+}
+
+void main_test_flat_map()
+{
+    BEGIN_TEST;
+
+    zen::flat_map<zen::string, int> m = { {"C", 3}, {"A", 1}, {"B", 2}, {"A", 10} };
+    m.insert({ "D", 4 });
+
+    ZEN_EXPECT(silent_print(m) == "[[A, 1], [B, 2], [C, 3], [D, 4]]");
+    ZEN_EXPECT( m.contains("A") && m.at("A") == 1);
+    ZEN_EXPECT(!m.contains("X") && m.find("X") == m.end());
+    ZEN_EXPECT(zen::is_empty(m) == m.is_empty());
+
+    m["E"] = 5;
+    m["A"] += 1;
+    m.find("B")->second = 20;
+    ZEN_EXPECT(m.at("A") == 2 && m.at("B") == 20 && m.size() == 5);
+    ZEN_EXPECT(m.values() == std::vector<int>({ 2, 20, 3, 4, 5 }));
+
+    m.insert_or_assign("C", 30);
+    ZEN_EXPECT(!m.try_emplace("C", 300).second && m.at("C") == 30);
+
+    int sum = 0;
+    for (auto [key, value] : m)
+        sum += value;
+    ZEN_EXPECT(sum == 61);
+
+    bool threw = false;
+    try {
+        (void)m.at("X");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw);
+
+    zen::flat_map<int, zen::string> kv({ 3, 1, 2 }, { "3", "1", "2" });
+    ZEN_EXPECT(silent_print(kv) == "[[1, 1], [2, 2], [3, 3]]");
+
+    // Bools are values like any other, not vector<bool> bits
+    zen::flat_map<int, bool> seen = { {2, true}, {1, false} };
+    seen[3] = true;
+    seen.find(1)->second = true;
+    bool& flag = seen.at(2);
+    flag = false;
+    ZEN_EXPECT(seen.values() == std::vector<bool>({ true, false, true }));
+    const zen::flat_map<int, bool> expected({ 3, 2, 1 }, { true, false, true });
+    ZEN_EXPECT(seen == expected);
+    zen::flat_multimap<int, bool> flags = { {1, true}, {1, false} };
+    ZEN_EXPECT(flags.count(1) == 2 && flags.begin()->second);
+
+    test_flat_map_against_std();
+}
+
+void main_test_flat_multimap()
+{
+    BEGIN_TEST;
+
+    zen::flat_multimap<zen::string, zen::string> mss = { {"B", "4"}, {"A", "1"}, {"A", "2"}, {"B", "5"}, {"A", "3"} };
+    mss.insert({ "D", "6" });
+    mss.insert({ "D", "7" });
+
+    ZEN_EXPECT(silent_print(mss) == "[[A, 1], [A, 2], [A, 3], [B, 4], [B, 5], [D, 6], [D, 7]]");
+    ZEN_EXPECT(mss.count("A") == 3 && mss.count("D") == 2 && mss.count("X") == 0);
+    ZEN_EXPECT((*mss.find("B")).second == "4");
+
+    mss.erase("A");
+    ZEN_EXPECT(mss.size() == 4 && !mss.contains("A"));
+    ZEN_EXPECT(zen::is_empty(mss) == mss.is_empty());
+}
+
+void main_test_flat_set()
+{
+    BEGIN_TEST;
+
+    zen::flat_set<int> s = { 5, 1, 4, 1, 3 };
+    s.insert(2);
+    s.insert(2);
+
+    ZEN_EXPECT(silent_print(s) == "[1, 2, 3, 4, 5]");
+    ZEN_EXPECT(s.contains(4) && !s.contains(6) && s.count(1) == 1);
+    ZEN_EXPECT(*s.lower_bound(0) == 1 && *s.upper_bound(3) == 4 && s.upper_bound(5) == s.end());
+
+    const std::vector<int> more = { 9, 0, 5, 7 };
+    s.insert(more.begin(), more.end());
+    ZEN_EXPECT(s.items() == std::vector<int>({ 0, 1, 2, 3, 4, 5, 7, 9 }));
+
+    const auto erased = s.erase(7) + s.erase(8);
+    ZEN_EXPECT(erased == 1 && s.size() == 7);
+    ZEN_EXPECT(zen::is_empty(s) == s.is_empty());
+}
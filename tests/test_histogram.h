@@ -0,0 +1,102 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+void test_histogram_percentiles()
+{
+    BEGIN_SUBTEST;
+
+    zen::histogram h;
+    for (std::uint64_t v = 1; v <= 100000; ++v)
+        h.record(v);
+
+    ZEN_EXPECT(h.count() == 100000);
+    ZEN_EXPECT(h.min()   == 1);
+    ZEN_EXPECT(h.max()   == 100000);
+
+    // 3 significant digits: every answer is within 0.1% of the exact one
+    auto near = [](std::uint64_t actual, double expected) { return std::abs(static_cast<double>(actual) - expected) <= expected * 0.001; };
+    ZEN_EXPECT(near(h.value_at_percentile(50),    50000));
+    ZEN_EXPECT(near(h.value_at_percentile(99),    99000));
+    ZEN_EXPECT(near(h.value_at_percentile(99.9),  99900));
+    ZEN_EXPECT(h.value_at_percentile(100) == 100000);
+    ZEN_EXPECT(near(static_cast<std::uint64_t>(h.mean()), 50000.5));
+
+    // Small values are exact
+    zen::histogram small;
+    small.record(7, 3);
+    ZEN_EXPECT(small.value_at_percentile(50) == 7 && small.count_at(7) == 3);
+
+    // Values past the trackable range are clamped rather than lost
+    zen::histogram clamped(1000);
+    clamped.record(5000);
+    ZEN_EXPECT(clamped.count() == 1 && clamped.max() == 1000);
+
+    ZEN_EXPECT_THROW(zen::histogram(1000, 7), std::invalid_argument);
+}
+
+void test_histogram_merge_and_serialize()
+{
+    BEGIN_SUBTEST;
+
+    zen::histogram a, b;
+    for (std::uint64_t v = 1; v <= 1000; ++v) a.record(v);
+    for (std::uint64_t v = 1; v <= 1000; ++v) b.record(v * 1000);
+
+    a.merge(b);
+    ZEN_EXPECT(a.count() == 2000 && a.min() == 1 && a.max() == 1000000);
+    ZEN_EXPECT(a.value_at_percentile(50) == 1000);
+
+    const std::string bytes = a.serialize();
+    const auto copy = zen::histogram::deserialize(bytes);
+    ZEN_EXPECT(bytes.size() < 8 * 1024); // far smaller than the bucket array itself
+    ZEN_EXPECT(copy.count() == a.count());
+    ZEN_EXPECT(copy.min()   == a.min() && copy.max() == a.max());
+    ZEN_EXPECT(copy.value_at_percentile(99.9) == a.value_at_percentile(99.9));
+
+    ZEN_EXPECT_THROW(zen::histogram::deserialize("garbage"),        std::invalid_argument);
+    ZEN_EXPECT_THROW(a.merge(zen::histogram(1000)),                 std::invalid_argument);
+
+    a.reset();
+    ZEN_EXPECT(a.is_empty() && a.value_at_percentile(99) == 0);
+}
+
+void main_test_histogram()
+{
+    BEGIN_TEST;
+
+    zen::histogram h;
+    for ([[maybe_unused]] int i : zen::in(10)) {
+        zen::timer t;
+        t.stop().record_into(h);
+    }
+    h.record(std::chrono::microseconds(5));
+
+    ZEN_EXPECT(h.count() == 11);
+    ZEN_EXPECT(h.max()   >= 5000);
+
+    test_histogram_percentiles();
+    test_histogram_merge_and_serialize();
+}
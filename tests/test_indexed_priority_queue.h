@@ -0,0 +1,114 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+// Shortest paths on a random graph: with keys updated in place versus with stale duplicates skipped
+void test_indexed_priority_queue_dijkstra()
+{
+    BEGIN_SUBTEST;
+    constexpr int n = 2'000;
+    zen::rng r(11);
+    std::vector<std::vector<std::pair<int, int>>> edges(n);
+    for (int i = 0; i < 10 * n; ++i)
+        edges[r.below(n)].emplace_back(static_cast<int>(r.below(n)), r.between(1, 100));
+
+    std::vector<long> lazy(n, -1);
+    std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>, std::greater<>> duplicates;
+    duplicates.push({ 0, 0 });
+    std::size_t most_duplicates = 0;
+    while (!duplicates.empty()) {
+        most_duplicates = std::max(most_duplicates, duplicates.size());
+        const auto [d, u] = duplicates.top();
+        duplicates.pop();
+        if (lazy[u] != -1)
+            continue; // stale
+        lazy[u] = d;
+        for (const auto& [v, w] : edges[u])
+            if (lazy[v] == -1)
+                duplicates.push({ d + w, v });
+    }
+
+    std::vector<long> dist(n, -1);
+    zen::indexed_priority_queue<int, long, std::greater<long>> q;
+    q.push(0, 0);
+    std::size_t most_keys = 0;
+    while (!q.is_empty()) {
+        most_keys = std::max(most_keys, q.size());
+        const int  u = q.top_key();
+        const long d = q.top_priority();
+        q.pop();
+        dist[u] = d;
+        for (const auto& [v, w] : edges[u]) {
+            if (dist[v] != -1)
+                continue;
+            if (!q.contains(v))
+                q.push(v, d + w);
+            else if (d + w < q.priority(v))
+                q.decrease_key(v, d + w);
+        }
+    }
+
+    ZEN_EXPECT(dist == lazy);
+    ZEN_EXPECT(most_keys <= static_cast<std::size_t>(n) && most_keys < most_duplicates);
+}
+
+void main_test_indexed_priority_queue()
+{
+    BEGIN_TEST;
+
+    zen::indexed_priority_queue<zen::string, int, std::less<int>, 4, zen::string_hash> q;
+    q.push("a", 1);
+    q.push("b", 5);
+    q.push("c", 3);
+    ZEN_EXPECT(!q.push("a", 100) && q.priority("a") == 1); // keys are unique
+    ZEN_EXPECT(q.top_key() == "b" && q.top_priority() == 5 && q.size() == 3);
+
+    q.increase_key("a", 9);
+    ZEN_EXPECT(q.top().first == "a" && q.top().second == 9);
+    q.decrease_key("a", 0);
+    q.update("d", 4); // adds
+    ZEN_EXPECT(q.top_key() == "b" && q.contains("d") && q.size() == 4);
+
+    const bool erased = q.erase("b");
+    const bool erased_again = q.erase("b");
+    ZEN_EXPECT(erased && !erased_again && q.top_key() == "d");
+
+    bool threw = false;
+    try {
+        q.decrease_key("x", 1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw && !q.contains("x"));
+
+    std::vector<zen::string> order;
+    for (; !q.is_empty(); q.pop())
+        order.push_back(q.top_key());
+    ZEN_EXPECT(order == std::vector<zen::string>({ "d", "c", "a" }));
+    ZEN_EXPECT(zen::is_empty(q) == q.is_empty());
+
+    // Random changes against a sorted set of (priority, key), on a binary heap
+    zen::indexed_priority_queue<int, int, std::less<int>, 2> b;
+    std::set<std::pair<int, int>> expected;
+    std::map<int, int> priorities;
+    zen::rng r(5);
+    bool same = true;
+    for (int i = 0; i < 20'000; ++i) {
+        const int key = r.between(0, 300), priority = r.between(0, 1'000);
+        if (r.below(3) == 0 && priorities.count(key)) {
+            b.erase(key);
+            expected.erase({ priorities[key], key });
+            priorities.erase(key);
+        } else {
+            b.update(key, priority);
+            if (priorities.count(key))
+                expected.erase({ priorities[key], key });
+            priorities[key] = priority;
+            expected.insert({ priority, key });
+        }
+        same &= b.size() == expected.size() && (b.is_empty() || b.top_priority() == expected.rbegin()->first);
+    }
+    ZEN_EXPECT(same);
+
+    test_indexed_priority_queue_dijkstra();
+}
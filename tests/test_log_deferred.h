@@ -0,0 +1,65 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include "test_logger.h" // for memory_sink
+
+void main_test_log_deferred()
+{
+    BEGIN_TEST;
+
+    auto sink = std::make_shared<memory_sink>();
+    zen::logger::start({ sink });
+
+    std::vector<int>         v  = { 1, 2, 3 };
+    std::vector<std::string> vs = { "a", "b" };
+    std::map<int, int>       m  = { {1, 2} }; // not deferrable: formatted right away
+
+    zen::log_deferred("order {} filled at {} in {}ns", 42, 101.25, 380);
+    zen::log_deferred("text {} {} {}", "literal", std::string("temporary"), zen::string("zen"));
+    zen::log_deferred("containers {} {} {}", v, vs, m);
+    zen::log_deferred("braces {{}} {}", 'c');
+    zen::log_deferred("more args than braces {}", 1, 2, 3);
+    zen::log_deferred("fewer args {} {}", true);
+    zen::log_deferred("no args");
+
+    zen::logger::stop();
+
+    ZEN_EXPECT(sink->text() ==
+        "order 42 filled at 101.25 in 380ns\n"
+        "text literal temporary zen\n"
+        "containers [1, 2, 3] [a, b] [[1, 2]]\n"
+        "braces {} c\n"
+        "more args than braces 1 2 3\n"
+        "fewer args 1 {}\n"
+        "no args\n");
+
+    // Without a running logger, the line is formatted and written right away
+    std::stringstream ss;
+    auto old_buf = std::cout.rdbuf(ss.rdbuf());
+    zen::log_deferred("sync {}", v);
+    std::cout.rdbuf(old_buf);
+    ZEN_EXPECT(ss.str() == "sync [1, 2, 3]\n");
+}
@@ -0,0 +1,119 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <thread>
+
+// Runs a piece of code with std::cout captured, so that sampled logs don't pollute the test log
+template<class Code>
+std::string captured_log(Code&& code) {
+    std::stringstream ss;
+    auto old_buf = std::cout.rdbuf(ss.rdbuf());
+    code();
+    std::cout.rdbuf(old_buf);
+    return ss.str();
+}
+
+void test_log_levels()
+{
+    BEGIN_SUBTEST;
+
+    const auto old_level = zen::get_log_level();
+    zen::set_log_level(zen::log_level::warning);
+
+    ZEN_EXPECT( zen::is_log_enabled(zen::log_level::error));
+    ZEN_EXPECT( zen::is_log_enabled(zen::log_level::warning));
+    ZEN_EXPECT(!zen::is_log_enabled(zen::log_level::info));
+    ZEN_EXPECT(!zen::is_log_enabled(zen::log_level::off));
+
+    int evaluated = 0;
+    auto expensive = [&] { ++evaluated; return 42; };
+
+    auto out = captured_log([&] {
+        zen::log_if(zen::log_level::debug, "debug");
+        zen::log_if(zen::log_level::error, "error", 1);
+        ZEN_LOG_IF(zen::log_level::info,    "info", expensive());
+        ZEN_LOG_IF(zen::log_level::warning, "warning", expensive());
+    });
+    ZEN_EXPECT(out == "error 1\nwarning 42\n");
+    ZEN_EXPECT(evaluated == 1); // skipped records don't evaluate their arguments
+
+    zen::set_log_level(old_level);
+}
+
+void test_log_sampling()
+{
+    BEGIN_SUBTEST;
+
+    int evaluated = 0;
+    auto counted = [&](int i) { ++evaluated; return i; };
+
+    auto out = captured_log([&] {
+        for (int i = 0; i < 10; ++i)
+            ZEN_LOG_EVERY_N(4, "every", counted(i));
+    });
+    ZEN_EXPECT(out == "every 0\nevery 4\nevery 8\n");
+    ZEN_EXPECT(evaluated == 3);
+
+    out = captured_log([&] {
+        for (int i = 0; i < 10; ++i)
+            ZEN_LOG_FIRST_N(2, "first", i);
+    });
+    ZEN_EXPECT(out == "first 0\nfirst 1\n");
+
+    // Each call site counts on its own
+    out = captured_log([&] {
+        for (int i = 0; i < 3; ++i) {
+            ZEN_LOG_FIRST_N(1, "site A", i);
+            ZEN_LOG_FIRST_N(1, "site B", i);
+        }
+    });
+    ZEN_EXPECT(out == "site A 0\nsite B 0\n");
+
+    // A long interval lets only the first pass through
+    out = captured_log([&] {
+        for (int i = 0; i < 1000; ++i)
+            ZEN_LOG_EVERY_MS(60'000, "throttled", i);
+    });
+    ZEN_EXPECT(out == "throttled 0\n");
+
+    // Several threads hitting the same site still share its budget
+    out = captured_log([&] {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([] { for (int i = 0; i < 1000; ++i) ZEN_LOG_FIRST_N(5, "racing"); });
+        for (auto& t : threads)
+            t.join();
+    });
+    ZEN_EXPECT(out == zen::repeat("racing\n", 5));
+}
+
+void main_test_log_sampling()
+{
+    BEGIN_TEST;
+
+    test_log_levels();
+    test_log_sampling();
+}
@@ -0,0 +1,243 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <thread>
+
+// Collects everything the logger writes, for inspection once it stops
+class memory_sink : public zen::log_sink {
+public:
+    void write(std::string_view text) override { std::lock_guard lock(mutex_); text_ += text; ++writes_; }
+    void flush()                      override { std::lock_guard lock(mutex_); ++flushes_; }
+
+    std::string text()    const { std::lock_guard lock(mutex_); return text_;    }
+    int         flushes() const { std::lock_guard lock(mutex_); return flushes_; }
+
+private:
+    mutable std::mutex mutex_;
+    std::string        text_;
+    int                writes_  = 0;
+    int                flushes_ = 0;
+};
+
+void test_logger_threads()
+{
+    BEGIN_SUBTEST;
+
+    auto sink = std::make_shared<memory_sink>();
+
+    zen::log_options options;
+    options.queue_size = 4096; // small, so that producers have to wait for the writer now and then
+    zen::logger::start({ sink }, options);
+    ZEN_EXPECT(zen::logger::is_running());
+
+    constexpr int threads = 4;
+    constexpr int lines   = 1000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t)
+        producers.emplace_back([t] {
+            for (int i = 0; i < lines; ++i)
+                zen::log("thread", t, "line", i);
+        });
+    for (auto& p : producers)
+        p.join();
+
+    zen::log(std::string(10000, 'x')); // larger than the whole ring
+
+    zen::logger::stop();
+    ZEN_EXPECT(!zen::logger::is_running());
+
+    // Every line arrives whole, and the lines of each thread arrive in order
+    std::istringstream in(sink->text());
+    std::string line;
+    std::vector<int> next(threads, 0);
+    int total = 0, broken = 0, oversized = 0;
+    while (std::getline(in, line)) {
+        int t = -1, i = -1;
+        if (line == std::string(10000, 'x')) { ++oversized; continue; }
+        if (std::sscanf(line.c_str(), "thread %d line %d", &t, &i) != 2 || t < 0 || t >= threads || next[t] != i) {
+            ++broken;
+            continue;
+        }
+        ++next[t];
+        ++total;
+    }
+    ZEN_EXPECT(total     == threads * lines);
+    ZEN_EXPECT(broken    == 0);
+    ZEN_EXPECT(oversized == 1);
+    ZEN_EXPECT(zen::logger::dropped() == 0);
+}
+
+void test_logger_stop_while_logging()
+{
+    BEGIN_SUBTEST;
+
+    auto sink = std::make_shared<memory_sink>();
+    zen::logger::start({ sink });
+
+    // Every line the logger took (submit returned true) must reach the sink, even
+    // the ones still being written into their rings while stop() runs
+    constexpr int threads = 4;
+    std::vector<int> accepted(threads, 0);
+    std::vector<std::thread> producers;
+    std::atomic<int> started = 0;
+    for (int t = 0; t < threads; ++t)
+        producers.emplace_back([t, &accepted, &started] {
+            ++started;
+            while (zen::logger::submit("thread " + std::to_string(t) + " line " + std::to_string(accepted[t])))
+                ++accepted[t];
+        });
+    while (started < threads)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    zen::logger::stop();
+    for (auto& p : producers)
+        p.join();
+
+    std::istringstream in(sink->text());
+    std::string line;
+    std::vector<int> next(threads, 0);
+    int broken = 0;
+    while (std::getline(in, line)) {
+        int t = -1, i = -1;
+        if (std::sscanf(line.c_str(), "thread %d line %d", &t, &i) != 2 || t < 0 || t >= threads || next[t] != i)
+            ++broken;
+        else
+            ++next[t];
+    }
+    ZEN_EXPECT(broken == 0);
+    ZEN_EXPECT(next == accepted);
+}
+
+// A sink whose first write blocks until it's opened, stalling the writer thread
+class gated_sink : public memory_sink {
+public:
+    void write(std::string_view text) override {
+        std::unique_lock lock(gate_mutex_);
+        blocked_ = true;
+        gate_.wait(lock, [this] { return open_; });
+        lock.unlock();
+        memory_sink::write(text);
+    }
+
+    bool blocked() const { std::lock_guard lock(gate_mutex_); return blocked_; }
+    void open() { { std::lock_guard lock(gate_mutex_); open_ = true; } gate_.notify_all(); }
+
+private:
+    mutable std::mutex      gate_mutex_;
+    std::condition_variable gate_;
+    bool                    blocked_ = false;
+    bool                    open_    = false;
+};
+
+void test_logger_dropped_oversized()
+{
+    BEGIN_SUBTEST;
+
+    auto sink = std::make_shared<gated_sink>();
+
+    zen::log_options options;
+    options.flush      = zen::flush_policy::every_record;
+    options.overflow   = zen::overflow_policy::drop;
+    options.queue_size = 64;
+    zen::logger::start({ sink }, options);
+
+    // With the writer stuck in the sink, fill the ring up so that the next record is dropped
+    zen::logger::submit("first");
+    while (!sink->blocked())
+        std::this_thread::yield();
+    while (zen::logger::submit("fill")) {}
+
+    const bool dropped = zen::logger::submit(std::string(100, 'a')); // oversized, and no room for its marker
+    sink->open();
+    zen::logger::flush();
+    const bool logged = zen::logger::submit(std::string(100, 'b'));
+    zen::logger::stop();
+
+    // The second oversized line comes out as itself, not as the dropped one
+    const auto text = sink->text();
+    ZEN_EXPECT(!dropped && logged);
+    ZEN_EXPECT(text.find(std::string(100, 'b')) != std::string::npos);
+    ZEN_EXPECT(text.find(std::string(100, 'a')) == std::string::npos);
+}
+
+void test_logger_flush()
+{
+    BEGIN_SUBTEST;
+
+    auto sink = std::make_shared<memory_sink>();
+
+    zen::log_options options;
+    options.flush = zen::flush_policy::manual;
+    zen::logger::start({ sink }, options);
+
+    zen::log("before flush");
+    zen::logger::flush();
+    const auto text    = sink->text();
+    const auto flushes = sink->flushes();
+    zen::logger::stop();
+
+    ZEN_EXPECT(text == "before flush\n");
+    ZEN_EXPECT(flushes >= 1);
+}
+
+void test_logger_rotating_file_sink()
+{
+    BEGIN_SUBTEST;
+
+    const auto dir = std::filesystem::temp_directory_path() / "kaizen_test_logger";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    {
+        zen::rotating_file_sink sink(dir / "app.log", 100, 3);
+        for (int i = 0; i < 30; ++i)
+            sink.write("0123456789ABCDEFGHI\n"); // 20 bytes per line, 5 lines per file
+        sink.flush();
+    }
+
+    ZEN_EXPECT( std::filesystem::exists(dir / "app.log"));
+    ZEN_EXPECT( std::filesystem::exists(dir / "app.log.1"));
+    ZEN_EXPECT( std::filesystem::exists(dir / "app.log.2"));
+    ZEN_EXPECT(!std::filesystem::exists(dir / "app.log.3"));
+    ZEN_EXPECT(std::filesystem::file_size(dir / "app.log.1") == 100);
+
+    std::filesystem::remove_all(dir);
+}
+
+void main_test_logger()
+{
+    BEGIN_TEST;
+
+    // Without a running logger, zen::log() writes straight to std::cout
+    ZEN_EXPECT(!zen::logger::is_running());
+    ZEN_EXPECT(!zen::logger::submit("nowhere to go"));
+
+    test_logger_threads();
+    test_logger_flush();
+    test_logger_stop_while_logging();
+    test_logger_dropped_oversized();
+    test_logger_rotating_file_sink();
+}
@@ -43,6 +43,17 @@ void main_test_multimap()
         mss["A"].size() == 3
     );
     ZEN_EXPECT(mss["D"].size() == 2);
+
+    // The values are a view: nothing is copied until converted to a vector
+    std::vector<zen::string> a = mss["A"];
+    ZEN_EXPECT(a == std::vector<zen::string>({ "1", "2", "3" }));
+    ZEN_EXPECT(silent_print(mss["B"]) == "[4, 5]");
+    ZEN_EXPECT(mss["X"].is_empty() && mss.count_of("X") == 0 && mss.count_of("A") == 3);
+
+    for (auto& value : mss["D"])
+        value += "!";
+    const auto& cmss = mss;
+    ZEN_EXPECT(cmss["D"].front() == "6!" && cmss["D"][1] == "7!");
     
     ZEN_EXPECT(zen::is_empty(mss) == mss.is_empty());
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+void test_parallel_pool()
+{
+    BEGIN_SUBTEST;
+
+    auto& pool = zen::internal::thread_pool::instance();
+
+    std::vector<int> hits(100);
+    pool.run(hits.size(), [&](std::size_t i) { ++hits[i]; });
+    ZEN_EXPECT(std::count(hits.begin(), hits.end(), 1) == 100);
+
+    // Tasks that start parallel work of their own run it serially instead of deadlocking
+    std::atomic<int> inner{ 0 };
+    pool.run(4, [&](std::size_t) { pool.run(4, [&](std::size_t) { ++inner; }); });
+    ZEN_EXPECT(inner == 16);
+
+    // An exception in any task reaches the caller, after all the tasks are done
+    std::atomic<int> finished{ 0 };
+    ZEN_EXPECT_THROW(pool.run(8, [&](std::size_t i) {
+        ++finished;
+        if (i == 3)
+            throw std::runtime_error("TASK FAILED");
+    }), std::runtime_error);
+    ZEN_EXPECT(finished == 8);
+
+    ZEN_EXPECT(zen::exec::is_execution_policy_v<decltype(zen::exec::par_unseq)>);
+    ZEN_EXPECT(!zen::exec::is_execution_policy_v<int>);
+}
+
+void test_parallel_algorithms()
+{
+    BEGIN_SUBTEST;
+
+    const std::size_t n = 3'000'000;
+    zen::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+
+    // The same answers under every policy
+    const long long expected = static_cast<long long>(n) * (n - 1) / 2;
+    std::vector<long long> w(v.begin(), v.end());
+    ZEN_EXPECT(zen::sum(zen::exec::seq, w)       == expected);
+    ZEN_EXPECT(zen::sum(zen::exec::par, w)       == expected);
+    ZEN_EXPECT(zen::sum(zen::exec::par_unseq, w) == expected);
+
+    std::vector<double> d(n, 0.25);
+    ZEN_EXPECT(zen::sum(zen::exec::seq, d, zen::summation::kahan) == n * 0.25);
+    ZEN_EXPECT(zen::sum(zen::exec::par, d, zen::summation::kahan) == n * 0.25);
+
+    ZEN_EXPECT( v.contains(zen::exec::par, 2'999'999));
+    ZEN_EXPECT(!v.contains(zen::exec::par, -1));
+    ZEN_EXPECT( v.contains(zen::exec::seq, [](int x) { return x > 2'999'990; }));
+    ZEN_EXPECT(!v.contains(zen::exec::par, [](int x) { return x < 0; }));
+
+    zen::array<int, 5> a = { 1, 2, 3, 4, 5 };
+    ZEN_EXPECT( a.contains(zen::exec::par, 5));
+    ZEN_EXPECT(!a.contains(zen::exec::seq, 6));
+
+    std::vector<int> r1(n), r2(n);
+    zen::generate_random(zen::exec::seq, r1, 0, 1000, 9);
+    zen::generate_random(zen::exec::par, r2, 0, 1000, 9);
+    ZEN_EXPECT(r1 == r2);
+
+    std::vector<double> g1(n), g2(n);
+    zen::generate_random(zen::exec::seq, g1, std::exponential_distribution<double>(2.0), 9);
+    zen::generate_random(zen::exec::par, g2, std::exponential_distribution<double>(2.0), 9);
+    ZEN_EXPECT(g1 == g2);
+
+    std::vector<int> small = { 1, 2, 3 };
+    ZEN_EXPECT(zen::to_string(zen::exec::par, small) == "[1, 2, 3]");
+    ZEN_EXPECT(zen::to_string(zen::exec::par, "text") == "text");
+    ZEN_EXPECT(zen::to_string(zen::exec::par, v) == zen::to_string(zen::exec::seq, v));
+}
+
+void main_test_parallel()
+{
+    BEGIN_TEST;
+
+    test_parallel_pool();
+    test_parallel_algorithms();
+}
@@ -4,6 +4,10 @@
 
 #include "../internal.h"
 
+#include <atomic>
+#include <thread>
+#include <mutex>
+
 // Making sink a local variable while keeping it volatile should theoretically
 // still prevent the compiler from optimizing away the operations on sink.
 // However, making it global is often a stronger guarantee against unwanted
@@ -12,6 +16,76 @@
 // variable whose usage scope is limited.
 volatile int sink; // global (see why above) to prevent loop optimization
 
+// Pushes items ints through a queue shared by threads threads (half producers, half
+// consumers; a single thread alternates) and returns the operations per second.
+template<class Push, class Pop>
+double queue_ops_per_second(int threads, int items, Push push, Pop pop)
+{
+    std::atomic<long long> total{0};
+    zen::timer tm;
+    if (threads == 1) {
+        for (int i = 0; i < items; ++i) {
+            push(i);
+            total += pop();
+        }
+    } else {
+        const int producers = threads / 2;
+        const int consumers = threads - producers;
+        std::vector<std::thread> pool;
+        for (int p = 0; p < producers; ++p)
+            pool.emplace_back([&, p] { for (int i = p; i < items; i += producers) push(i); });
+        for (int c = 0; c < consumers; ++c)
+            pool.emplace_back([&, c] {
+                long long sum = 0;
+                for (int i = c; i < items; i += consumers) sum += pop();
+                total += sum;
+            });
+        for (auto& t : pool)
+            t.join();
+    }
+    tm.stop();
+    sink = sink + static_cast<int>(total.load());
+    const double seconds = static_cast<double>(tm.duration<zen::timer::nsec>().count()) / 1e9;
+    return 2.0 * items / (seconds > 0 ? seconds : 1e-9);
+}
+
+// The lock-free queues against the zen::queue behind a mutex they're meant to replace
+void perf_test_concurrent_queues()
+{
+    const int N = 20'000; // use 10M for Release/optimized mode
+
+    for (int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        zen::mpmc_queue<int> mpmc(1024);
+        const auto lock_free = queue_ops_per_second(threads, N,
+            [&](int x) { mpmc.wait_push(x); },
+            [&]        { int x; mpmc.wait_pop(x); return x; });
+
+        std::mutex mutex;
+        zen::queue<int> q;
+        const auto locked = queue_ops_per_second(threads, N,
+            [&](int x) { std::lock_guard lock(mutex); q.push(x); },
+            [&] {
+                for (;;) {
+                    {
+                        std::lock_guard lock(mutex);
+                        if (!q.empty()) { const int x = q.front(); q.pop(); return x; }
+                    }
+                    std::this_thread::yield();
+                }
+            });
+
+        zen::log("PERF OPS/SEC WITH", threads, "THREADS FOR zen::mpmc_queue:", static_cast<long long>(lock_free));
+        zen::log("PERF OPS/SEC WITH", threads, "THREADS FOR MUTEX zen::queue:", static_cast<long long>(locked));
+    }
+
+    // One producer and one consumer, the only shape zen::spsc_queue allows
+    zen::spsc_queue<int> spsc(1024);
+    const auto single = queue_ops_per_second(2, N,
+        [&](int x) { spsc.wait_push(x); },
+        [&]        { int x; spsc.wait_pop(x); return x; });
+    zen::log("PERF OPS/SEC WITH 2 THREADS FOR zen::spsc_queue:", static_cast<long long>(single));
+}
+
 void main_test_performance()
 {
     BEGIN_TEST;
@@ -35,5 +109,14 @@ void main_test_performance()
     zen::log("PERF TIME FOR zen::in:", t1);
     zen::log("PERF TIME FOR RAW for:", t2);
 
+    // Same loops with hardware counters (IPC and misses show where perf events are permitted)
+    const auto b1 = zen::benchmark([&] { for (int i : zen::in(N))    sink = sink + i; }, 10);
+    const auto b2 = zen::benchmark([&] { for (int i = 0; i < N; ++i) sink = sink + i; }, 10);
+
+    zen::log("PERF STAT FOR zen::in:", b1.to_string());
+    zen::log("PERF STAT FOR RAW for:", b2.to_string());
+
+    perf_test_concurrent_queues();
+
     silent_print(sink); // to ensure it's used
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+void main_test_perf_counters()
+{
+    BEGIN_TEST;
+
+    zen::perf_counters pc;
+    volatile std::uint64_t x = 0;
+    for (int i : zen::in(100'000))
+        x = x + static_cast<std::uint64_t>(i);
+    const auto c = pc.stop();
+
+    // Whether or not perf events are permitted here, the results stay consistent
+    ZEN_EXPECT(c.available == pc.is_available());
+    if (c.available) {
+        ZEN_EXPECT(c.cycles > 0 || c.instructions > 0);
+        ZEN_EXPECT(c.ipc() >= 0.0);
+    } else {
+        ZEN_EXPECT(c.cycles == 0 && c.instructions == 0 && c.ipc() == 0.0);
+    }
+
+    // Counting can be restarted and stopped counters don't move
+    pc.start();
+    const auto c2 = pc.stop();
+    ZEN_EXPECT(pc.read().instructions == c2.instructions);
+
+    // A timer can carry the counts of the region it timed
+    zen::counted_timer t;
+    for (int i : zen::in(100'000))
+        x = x + static_cast<std::uint64_t>(i);
+    const auto& tc = t.stop().counts();
+    ZEN_EXPECT(t.duration<zen::timer::nsec>().count() > 0);
+    ZEN_EXPECT(tc.available == pc.is_available());
+    ZEN_EXPECT(tc.available ? tc.instructions > 0 : tc.instructions == 0);
+
+    const auto r = zen::benchmark([&] { x = x + 1; }, 1000);
+    ZEN_EXPECT(r.iterations == 1000);
+    ZEN_EXPECT(r.per_iteration.count() >= 0.0);
+
+    const zen::string report = r.to_string();
+    ZEN_EXPECT(report.contains(" ns/iter"));
+    ZEN_EXPECT(report.contains("IPC") == r.counts.available);
+}
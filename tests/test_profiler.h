@@ -0,0 +1,98 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <thread>
+
+void test_profiler_threads()
+{
+    BEGIN_SUBTEST;
+
+    static const auto zone = zen::profiler::register_zone("test_profiler_threads");
+
+    // The threads are gone by the time we look, but their measurements aren't
+    auto work = [] {
+        for ([[maybe_unused]] int i : zen::in(100)) {
+            zen::profile_scope scope(zone);
+        }
+    };
+    std::thread t1(work);
+    std::thread t2(work);
+    t1.join();
+    t2.join();
+
+    const auto all = zen::profiler::stats();
+    ZEN_EXPECT(zone < all.size());
+
+    const auto& s = all[zone];
+    ZEN_EXPECT(s.name  == "test_profiler_threads");
+    ZEN_EXPECT(s.count == 200);
+    ZEN_EXPECT(s.min_ns <= s.max_ns && s.total_ns >= s.max_ns);
+    ZEN_EXPECT(s.percentile_ns(50) <= s.percentile_ns(99));
+
+    std::uint64_t in_histogram = 0;
+    for (auto n : s.histogram)
+        in_histogram += n;
+    ZEN_EXPECT(in_histogram == s.count);
+}
+
+void test_profiler_report()
+{
+    BEGIN_SUBTEST;
+
+    static const auto zone = zen::profiler::register_zone("test_profiler_report");
+    {
+        zen::profile_scope scope(zone);
+        ZEN_PROFILE_SCOPE("test_profiler_macro"); // compiles either way, records only if enabled
+    }
+
+    const zen::string table = zen::profiler::table();
+    ZEN_EXPECT(table.starts_with("ZONE"));
+    ZEN_EXPECT(table.contains("test_profiler_report"));
+
+    const auto trace = std::filesystem::temp_directory_path() / "kaizen_test_trace.json";
+    ZEN_EXPECT(zen::profiler::write_chrome_trace(trace));
+
+    {
+        zen::ifile file(trace);
+        const zen::string json = file.getline(1);
+        ZEN_EXPECT(json.starts_with("{\"traceEvents\":["));
+    }
+    std::filesystem::remove(trace);
+}
+
+void main_test_profiler()
+{
+    BEGIN_TEST;
+
+    ZEN_EXPECT(zen::zone_stats::bucket_of(0)    ==  0);
+    ZEN_EXPECT(zen::zone_stats::bucket_of(1)    ==  0);
+    ZEN_EXPECT(zen::zone_stats::bucket_of(2)    ==  1);
+    ZEN_EXPECT(zen::zone_stats::bucket_of(1023) ==  9);
+    ZEN_EXPECT(zen::zone_stats::bucket_of(1024) == 10);
+
+    test_profiler_threads();
+    test_profiler_report();
+}
@@ -15,6 +15,58 @@ void test_priority_queue_of_strings()
     );
 }
 
+// Heap construction, bulk pushes and pops of the top elements against a sorted copy
+template<class Queue>
+bool drains_in_order(Queue q, std::vector<int> expected)
+{
+    std::sort(expected.rbegin(), expected.rend());
+    std::vector<int> got;
+    while (!q.is_empty()) {
+        got.push_back(q.top());
+        q.pop();
+    }
+    return got == expected;
+}
+
+void test_priority_queue_bulk()
+{
+    BEGIN_SUBTEST;
+    std::vector<int> v(10'000);
+    zen::generate_random(v, -1'000, 1'000, 1);
+
+    zen::priority_queue<int> q(v);
+    zen::d_ary_priority_queue<int> d(v);
+    zen::d_ary_priority_queue<int, 3> d3(v);
+    ZEN_EXPECT(q.size() == v.size() && q.top() == *std::max_element(v.begin(), v.end()));
+    ZEN_EXPECT(drains_in_order(q, v) && drains_in_order(d, v) && drains_in_order(d3, v));
+
+    // Few new elements get sifted up, many make the heap get rebuilt
+    std::vector<int> all = v;
+    for (std::size_t k : { 3, 20'000 }) {
+        std::vector<int> more(k);
+        zen::generate_random(more, -2'000, 2'000, k);
+        q.push_range(more);
+        d.push_range(more);
+        all.insert(all.end(), more.begin(), more.end());
+        ZEN_EXPECT(drains_in_order(q, all) && drains_in_order(d, all));
+    }
+
+    std::vector<int> sorted = all;
+    std::sort(sorted.rbegin(), sorted.rend());
+    const auto top_q = q.pop_n(5);
+    const auto top_d = d.pop_n(5);
+    ZEN_EXPECT(top_q == std::vector<int>(sorted.begin(), sorted.begin() + 5) && top_d == top_q);
+    ZEN_EXPECT(q.size() == all.size() - 5 && d.size() == q.size() && q.top() == sorted[5] && d.top() == sorted[5]);
+    ZEN_EXPECT(zen::priority_queue<int>(zen::ints{ 3, 9, 1, 5 }).pop_n(9) == std::vector<int>({ 9, 5, 3, 1 }));
+
+    // Moving a container in, with a custom order
+    zen::d_ary_priority_queue<zen::string, 4, std::vector<zen::string>, std::greater<zen::string>> s(zen::strings{ "b", "c", "a" });
+    s.emplace("0");
+    const auto first_two = s.pop_n(2);
+    ZEN_EXPECT(first_two == std::vector<zen::string>({ "0", "a" }) && s.top() == "b");
+    ZEN_EXPECT(zen::is_empty(s) == s.is_empty());
+}
+
 void test_queue_of_strings()
 {
     BEGIN_SUBTEST;
@@ -39,6 +91,7 @@ void main_test_priority_queue()
     );
 
     test_priority_queue_of_strings();
+    test_priority_queue_bulk();
 }
 
 void main_test_queue()
@@ -0,0 +1,118 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+void test_reduce_sum()
+{
+    BEGIN_SUBTEST;
+
+    // Fewer than 8 elements add up exactly like the plain running sum
+    std::array<double, 3> a = { 1.1, 2.2, 3.3 };
+    ZEN_EXPECT(zen::sum(a) == 6.6);
+
+    // From 8 on they don't: element i goes to lane i % 8 and the lanes are added pairwise.
+    // Here the big ones cancel within their lane, where a running sum loses half the ones to them.
+    std::vector<double> lanes(16, 1.0);
+    lanes[0] =  1e16;
+    lanes[8] = -1e16;
+    double running = 0;
+    for (double x : lanes)
+        running += x;
+    ZEN_EXPECT(running == 7.0);
+    ZEN_EXPECT(zen::sum(lanes) == 14.0);
+    ZEN_EXPECT(zen::sum(lanes, zen::summation::pairwise) == 14.0);
+
+    zen::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 1);
+    ZEN_EXPECT(zen::sum(v) == 500'500);
+
+    // Large inputs go through the lanes, the pairwise tree and the threads
+    const std::size_t n = 2'000'001;
+    zen::reals r(n, 0.1);
+    ZEN_EXPECT(std::abs(zen::sum(r) - n * 0.1) < 1e-6);
+    ZEN_EXPECT(std::abs(zen::sum(r, zen::summation::kahan) - n * 0.1) < 1e-8);
+    ZEN_EXPECT(std::abs(zen::sum(r, zen::summation::fast) - n * 0.1) < 1e-3);
+
+    // Where a running sum in float drifts, pairwise and Kahan don't
+    std::vector<float> f(10'000'000, 0.1f);
+    ZEN_EXPECT(std::abs(zen::sum(f) - 1e6f) < 1.0f);
+    ZEN_EXPECT(std::abs(zen::sum(f, zen::summation::kahan) - 1e6f) < 0.5f);
+
+    // Kahan recovers what a plain sum loses entirely
+    std::vector<double> tiny = { 1.0, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16, 1e-16 };
+    ZEN_EXPECT(zen::sum(tiny, zen::summation::kahan) == 1.0 + 1e-15);
+
+    std::list<double> l = { 0.5, 0.25 };
+    ZEN_EXPECT(zen::sum(l, zen::summation::kahan) == 0.75);
+
+    // Generic Addable types still work
+    std::vector<std::string> s = { "ab", "cd" };
+    ZEN_EXPECT(zen::sum(s) == "abcd");
+}
+
+void test_reduce_statistics()
+{
+    BEGIN_SUBTEST;
+
+    std::vector<int> v = { 3, -7, 12, 0, 5 };
+    ZEN_EXPECT(zen::min(v) == -7);
+    ZEN_EXPECT(zen::max(v) == 12);
+    ZEN_EXPECT(zen::minmax(v) == std::make_pair(-7, 12));
+
+    std::list<int> l(v.begin(), v.end());
+    ZEN_EXPECT(zen::minmax(l) == std::make_pair(-7, 12));
+    ZEN_EXPECT(zen::min(std::set<std::string>{ "b", "a" }) == "a");
+
+    std::vector<double> big(1'000'000);
+    std::iota(big.begin(), big.end(), 0.0);
+    big[123'456] = -1.0;
+    ZEN_EXPECT(zen::min(big) == -1.0);
+    ZEN_EXPECT(zen::max(big) == 999'999.0);
+
+    ZEN_EXPECT(zen::mean(std::vector{ 1, 2, 3, 4 }) == 2.5);
+    ZEN_EXPECT(zen::variance(std::vector{ 1.0, 2.0, 3.0, 4.0 }) == 1.25);
+    ZEN_EXPECT(std::abs(zen::variance(std::vector{ 1.0, 2.0, 3.0, 4.0 }, true) - 5.0 / 3) < 1e-12);
+
+    // No catastrophic cancellation around a large offset
+    std::vector<double> offset = { 1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16 };
+    ZEN_EXPECT(zen::variance(offset) == 22.5);
+
+    ZEN_EXPECT(zen::dot(std::vector{ 1, 2, 3 }, std::array<int, 3>{ 4, 5, 6 }) == 32);
+    ZEN_EXPECT(zen::dot(std::list{ 1.5 }, std::vector{ 2.0 }) == 3.0);
+
+    std::vector<int> empty;
+    ZEN_EXPECT_THROW(zen::min(empty),                              std::invalid_argument);
+    ZEN_EXPECT_THROW(zen::mean(empty),                             std::invalid_argument);
+    ZEN_EXPECT_THROW(zen::variance(std::vector{ 1.0 }, true),      std::invalid_argument);
+    ZEN_EXPECT_THROW(zen::dot(std::vector{ 1 }, std::vector{ 1, 2 }), std::invalid_argument);
+}
+
+void main_test_reduce()
+{
+    BEGIN_TEST;
+
+    test_reduce_sum();
+    test_reduce_statistics();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include "../internal.h"
+
+// Counts the allocations made through it
+template<class T>
+struct counting_allocator {
+    using value_type = T;
+
+    inline static int allocations = 0;
+
+    counting_allocator() = default;
+    template<class U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n) { ++allocations; return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    friend bool operator==(const counting_allocator&, const counting_allocator&) { return true; }
+    friend bool operator!=(const counting_allocator&, const counting_allocator&) { return false; }
+};
+
+void test_ring_buffer_steady_state()
+{
+    BEGIN_SUBTEST;
+    zen::ring_buffer<zen::string, true, counting_allocator<zen::string>> r(100);
+    ZEN_EXPECT(r.capacity() == 128 && counting_allocator<zen::string>::allocations == 1);
+
+    // A producer a bit ahead of its consumer, for a long while
+    bool in_order = true;
+    int next = 0;
+    for (int i = 0; i < 100'000; ++i) {
+        r.push_back(std::to_string(i));
+        if (r.size() > 50) {
+            in_order &= r.front() == std::to_string(next++);
+            r.pop_front();
+        }
+    }
+    ZEN_EXPECT(in_order && r.size() == 50);
+    ZEN_EXPECT(counting_allocator<zen::string>::allocations == 1); // no more than the first one
+}
+
+void main_test_ring_buffer()
+{
+    BEGIN_TEST;
+
+    zen::ring_buffer<int> r = { 1, 2, 3 };
+    r.push_front(0);
+    r.push_back(4);
+    ZEN_EXPECT(silent_print(r) == "[0, 1, 2, 3, 4]");
+    ZEN_EXPECT(r.capacity() == 8 && r.at(4) == 4 && r[0] == 0);
+
+    // Past the end of the buffer and around
+    for (int i = 5; i < 12; ++i) {
+        r.push_back(i);
+        r.pop_front();
+    }
+    const auto front = r.front_span();
+    const auto back  = r.back_span();
+    ZEN_EXPECT(front.size + back.size == r.size() && !back.empty());
+    ZEN_EXPECT(std::equal(front.begin(), front.end(), r.begin()) && std::equal(back.begin(), back.end(), r.begin() + front.size));
+    ZEN_EXPECT(std::is_sorted(r.begin(), r.end()) && r.front() == 7 && r.back() == 11);
+
+    for (int i = 12; i < 40; ++i) // grows, keeping the order
+        r.push_back(i);
+    ZEN_EXPECT(r.capacity() == 64 && r.size() == 33 && std::is_sorted(r.begin(), r.end()));
+    ZEN_EXPECT(zen::is_empty(r) == r.is_empty());
+
+    zen::ring_buffer<int, false> fixed(3);
+    for (int i = 0; i < 8; ++i)
+        fixed.push_back(i);
+    bool threw = false;
+    try {
+        fixed.push_back(8);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw && fixed.is_full() && fixed.size() == 8);
+
+    // A fixed-size buffer that was never given a size has no room at all
+    zen::ring_buffer<int, false> unsized;
+    threw = false;
+    try {
+        unsized.push_back(1);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw && unsized.capacity() == 0 && unsized.is_empty());
+
+    // Pushing its own elements into a full buffer, which has to grow under them
+    zen::ring_buffer<zen::string> own(8);
+    for (int i = 0; i < 8; ++i)
+        own.push_back(zen::string(20, static_cast<char>('a' + i))); // long enough to be on the heap
+    own.push_back(own.front());
+    ZEN_EXPECT(own.capacity() == 16 && own.back() == zen::string(20, 'a'));
+    for (int i = 0; i < 7; ++i)
+        own.push_back("x");
+    own.emplace_front(own.back());
+    ZEN_EXPECT(own.size() == 17 && own.front() == "x" && own[1] == zen::string(20, 'a'));
+
+    test_ring_buffer_steady_state();
+}
+
+void main_test_ring_queue()
+{
+    BEGIN_TEST;
+
+    zen::ring_queue<int> q(zen::ints{ 1, 2, 3 });
+    q.push(4);
+    ZEN_EXPECT(q.front() == 1 && q.back() == 4 && q.size() == 4);
+    ZEN_EXPECT(zen::is_empty(q) == q.is_empty());
+
+    // Bulk dequeuing
+    zen::ring_queue<int> big(1000);
+    for (int i = 0; i < 1000; ++i)
+        big.push(i);
+    long sum = 0;
+    for (int x : big.front_span())
+        sum += x;
+    big.pop(big.front_span().size);
+    ZEN_EXPECT(sum == 499'500 && big.is_empty() && big.capacity() == 1024);
+
+    zen::queue<zen::string, zen::ring_buffer<zen::string>> strings = zen::strings{ "1", "2" };
+    strings.push("3");
+    strings.pop();
+    ZEN_EXPECT(strings.front() == "2" && strings.size() == 2);
+}
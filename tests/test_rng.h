@@ -0,0 +1,221 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include <thread>
+
+template<class Engine>
+void test_rng_engine()
+{
+    BEGIN_SUBTEST;
+
+    // The same seed gives the same sequence, different seeds different ones
+    Engine a(42), b(42), c(43);
+    bool same = true, different = false;
+    for (int i = 0; i < 100; ++i) {
+        const auto x = a(), y = b(), z = c();
+        same      = same      && x == y;
+        different = different || x != z;
+    }
+    ZEN_EXPECT(same);
+    ZEN_EXPECT(different);
+
+    // Works with the standard distributions
+    std::uniform_int_distribution<int> dist(1, 6);
+    int roll = dist(a);
+    ZEN_EXPECT(roll >= 1 && roll <= 6);
+}
+
+void test_rng_bounds()
+{
+    BEGIN_SUBTEST;
+
+    zen::rng r(7);
+
+    // Closed interval, every value reachable, roughly uniform
+    int counts[6] = {};
+    bool in_range = true;
+    for (int i = 0; i < 60'000; ++i) {
+        const int x = r.between(1, 6);
+        in_range = in_range && x >= 1 && x <= 6;
+        if (x >= 1 && x <= 6)
+            ++counts[x - 1];
+    }
+    ZEN_EXPECT(in_range);
+    ZEN_EXPECT(*std::min_element(std::begin(counts), std::end(counts)) > 9'000);
+    ZEN_EXPECT(*std::max_element(std::begin(counts), std::end(counts)) < 11'000);
+
+    // Degenerate, negative and full ranges
+    ZEN_EXPECT(r.between(5, 5) == 5);
+    const int neg = r.between(-3, -1);
+    ZEN_EXPECT(neg >= -3 && neg <= -1);
+    const auto full = r.between(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max());
+    ZEN_EXPECT(full >= std::numeric_limits<std::int64_t>::min()); // no overflow trap
+    const std::uint8_t byte = r.between<std::uint8_t>(0, 255);
+    ZEN_EXPECT(byte <= 255);
+
+    ZEN_EXPECT(r.below(1) == 0);
+    ZEN_EXPECT(r.below(10) < 10);
+
+    const double d = r.uniform(2.0, 3.0);
+    ZEN_EXPECT(d >= 2.0 && d < 3.0);
+
+    // The largest draws stay below max, in float too, and where the scaling itself rounds up
+    const std::uint64_t all_ones = ~std::uint64_t(0);
+    ZEN_EXPECT(zen::internal::from_random_bits(all_ones, 0.0f, 1.0f) < 1.0f);
+    ZEN_EXPECT(zen::internal::from_random_bits(all_ones, 0.0, 1.0) < 1.0);
+    const double next = std::nextafter(1.0, 2.0);
+    ZEN_EXPECT(zen::internal::from_random_bits(all_ones, 1.0, next) == 1.0);
+    bool below = true;
+    for (int i = 0; i < 100'000; ++i)
+        below &= r.uniform(0.0f, 1.0f) < 1.0f;
+    ZEN_EXPECT(below);
+}
+
+void test_rng_fill()
+{
+    BEGIN_SUBTEST;
+
+    zen::rng r1(1), r2(1);
+    std::vector<int> v(1000), w(1000);
+    r1.fill(v, 10, 99);
+    r2.fill(w, 10, 99);
+    ZEN_EXPECT(v == w);
+    ZEN_EXPECT(*std::min_element(v.begin(), v.end()) >= 10);
+    ZEN_EXPECT(*std::max_element(v.begin(), v.end()) <= 99);
+
+    std::array<double, 100> a;
+    r1.fill(a, -1.0, 1.0);
+    ZEN_EXPECT(*std::min_element(a.begin(), a.end()) >= -1.0);
+    ZEN_EXPECT(*std::max_element(a.begin(), a.end()) <   1.0);
+
+    std::vector<std::uint64_t> bits(4);
+    r1.fill(bits);
+    ZEN_EXPECT(bits[0] != bits[1]);
+
+    // Jumped xoshiro streams don't overlap
+    zen::xoshiro256ss x(5), y(5);
+    y.jump();
+    ZEN_EXPECT(x() != y());
+}
+
+void test_rng_threads()
+{
+    BEGIN_SUBTEST;
+
+    // Reproducible on the seeding thread
+    zen::set_random_seed(123);
+    const int first = zen::random_int(0, 1'000'000);
+    zen::set_random_seed(123);
+    const int again = zen::random_int(0, 1'000'000);
+    ZEN_EXPECT(again == first);
+
+    // Many threads drawing at once: each owns its engine, so no races (run under TSan to see)
+    std::vector<std::thread> threads;
+    std::atomic<int> out_of_range{ 0 };
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10'000; ++i) {
+                const int x = zen::random_int(10, 99);
+                if (x < 10 || x > 99)
+                    ++out_of_range;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    ZEN_EXPECT(out_of_range == 0);
+
+    zen::set_random_seed(0); // back to nondeterministic seeding
+}
+
+void test_rng_generate_random()
+{
+    BEGIN_SUBTEST;
+
+    // Known-answer test from the Random123 reference: counter and key all zeros
+    const auto block = zen::philox4x32::block(0, 0);
+    ZEN_EXPECT(block[0] == 0x6627e8d5 && block[1] == 0xe169c58d && block[2] == 0xbc57ac4c && block[3] == 0x9b00dbd8);
+
+    // Same seed, same contents, regardless of container type or of how many threads filled it
+    const std::size_t n = 200'000; // above the threshold for filling in parallel
+    std::vector<int> v(n);
+    std::list<int>   l(n);
+    zen::generate_random(v, 1, 6, 42);
+    zen::generate_random(l, 1, 6, 42);
+    ZEN_EXPECT(std::equal(v.begin(), v.end(), l.begin()));
+    ZEN_EXPECT(*std::min_element(v.begin(), v.end()) == 1);
+    ZEN_EXPECT(*std::max_element(v.begin(), v.end()) == 6);
+
+    std::vector<int> w(n);
+    zen::generate_random(w, 1, 6, 43);
+    ZEN_EXPECT(v != w);
+
+    std::array<float, 7> a;
+    zen::generate_random(a, 0.5f, 1.5f, 1);
+    ZEN_EXPECT(*std::min_element(a.begin(), a.end()) >= 0.5f);
+    ZEN_EXPECT(*std::max_element(a.begin(), a.end()) <  1.5f);
+
+    std::vector<double> empty;
+    zen::generate_random(empty, -1.0, 1.0);
+    ZEN_EXPECT(empty.size() == 10);
+
+    // The simplest overload, on containers of every kind
+    std::vector<int> simple;
+    zen::generate_random(simple, 25);
+    std::array<long, 12> fixed;
+    zen::generate_random(fixed);
+    std::list<double> linked(30);
+    zen::generate_random(linked);
+    std::deque<short> none;
+    zen::generate_random(none, 0);
+    const auto in_range = [](const auto& c) { return std::all_of(c.begin(), c.end(), [](auto x) { return x >= 10 && x <= 99; }); };
+    ZEN_EXPECT(simple.size() == 25 && in_range(simple) && in_range(fixed) && in_range(linked));
+    ZEN_EXPECT(linked.size() == 30 && none.empty());
+
+    // Any distribution, just as reproducible
+    std::vector<double> d1(n), d2(n);
+    std::deque<double>  d3(n);
+    zen::generate_random(d1, std::normal_distribution<double>(100.0, 1.0), 7);
+    zen::generate_random(d2, std::normal_distribution<double>(100.0, 1.0), 7);
+    zen::generate_random(d3, std::normal_distribution<double>(100.0, 1.0), 7);
+    ZEN_EXPECT(d1 == d2);
+    ZEN_EXPECT(std::equal(d1.begin(), d1.end(), d3.begin()));
+    const double mean = std::accumulate(d1.begin(), d1.end(), 0.0) / n;
+    ZEN_EXPECT(mean > 99.9 && mean < 100.1);
+}
+
+void main_test_rng()
+{
+    BEGIN_TEST;
+
+    test_rng_engine<zen::xoshiro256ss>();
+    test_rng_engine<zen::wyrand>();
+    test_rng_engine<zen::pcg32>();
+    test_rng_bounds();
+    test_rng_fill();
+    test_rng_threads();
+    test_rng_generate_random();
+}
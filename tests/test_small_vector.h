@@ -0,0 +1,82 @@
+#pragma once
+
+#include "kaizen.h" // test using generated header: jump with the parachute you folded
+
+#include "../internal.h"
+
+// Moves and copies of inline and heap small vectors of elements that own memory
+void test_small_vector_of_strings()
+{
+    BEGIN_SUBTEST;
+    zen::small_vector<zen::string, 2> v = { "1", "2" };
+    ZEN_EXPECT(v.is_inline() && v.contains("2"));
+
+    v.push_back("a string long enough to be on the heap itself");
+    ZEN_EXPECT(!v.is_inline() && v.size() == 3 && v.capacity() >= 3);
+
+    const zen::string* heap = v.data();
+    zen::small_vector<zen::string, 2> moved = std::move(v);
+    ZEN_EXPECT(moved.data() == heap && v.is_empty() && v.is_inline()); // the heap buffer is stolen
+
+    zen::small_vector<zen::string, 2> few = { "x" };
+    zen::small_vector<zen::string, 2> taken = std::move(few); // inline elements are moved
+    ZEN_EXPECT(taken.is_inline() && taken.size() == 1 && taken[0] == "x" && few.is_empty());
+
+    zen::small_vector<zen::string, 2> copy = moved;
+    ZEN_EXPECT(copy == moved && copy.data() != moved.data());
+
+    copy.swap(taken);
+    ZEN_EXPECT(taken == moved && copy.size() == 1 && copy[0] == "x");
+
+    moved.erase(moved.begin());
+    moved.pop_back();
+    moved.shrink_to_fit();
+    ZEN_EXPECT(moved.is_inline() && moved.size() == 1 && moved[0] == "2");
+
+    // Elements of the vector itself as arguments, also when it has to grow
+    zen::small_vector<zen::string, 2> self = { "a", "b" };
+    self.push_back(self[0]);
+    self.insert(self.begin(), 2, self[2]);
+    ZEN_EXPECT(silent_print(self) == "[a, a, a, b, a]");
+}
+
+void main_test_small_vector()
+{
+    BEGIN_TEST;
+
+    zen::small_ints v;
+    ZEN_EXPECT(v.is_inline() && v.capacity() == 8);
+    for (int i = 0; i < 8; ++i)
+        v.push_back(i);
+    ZEN_EXPECT(v.is_inline() && v.size() == 8);
+    v.push_back(8); // only now goes to the heap
+    ZEN_EXPECT(!v.is_inline() && v.size() == 9 && v.back() == 8);
+
+    ZEN_EXPECT(v.contains(5) && !v.contains(50) && v.index_of(8) == 8 && v.count(3) == 1);
+    ZEN_EXPECT(v.contains([](int x) { return x > 7; }) && v.contains_any({ 42, 7 }));
+    ZEN_EXPECT(v.contains(zen::exec::par, 8) && !v.contains(zen::exec::par, 90));
+    ZEN_EXPECT(zen::is_empty(v) == v.is_empty());
+    ZEN_EXPECT(zen::sum(v) == 36);
+
+    v.insert(v.begin() + 1, { 10, 11 });
+    v.erase(v.begin() + 4, v.end() - 2);
+    ZEN_EXPECT(silent_print(v) == "[0, 10, 11, 1, 7, 8]");
+
+    v.resize(3);
+    v.resize(5, -1);
+    ZEN_EXPECT(v == zen::small_ints({ 0, 10, 11, -1, -1 }) && v < zen::small_ints({ 0, 11 }));
+
+    bool threw = false;
+    try {
+        (void)v.at(5);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ZEN_EXPECT(threw);
+
+    zen::small_reals r(3, 0.5);
+    zen::generate_random(r, 1.0, 2.0);
+    ZEN_EXPECT(r.size() == 3 && r.is_inline() && std::all_of(r.begin(), r.end(), [](double x) { return x >= 1.0 && x < 2.0; }));
+
+    test_small_vector_of_strings();
+}
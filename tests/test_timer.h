@@ -4,6 +4,54 @@
 
 #include <thread>
 
+void test_tsc_timer()
+{
+    BEGIN_SUBTEST;
+
+    using namespace std::chrono;
+
+    zen::tsc_timer timer;
+    std::this_thread::sleep_for(milliseconds(2));
+    timer.stop();
+
+    ZEN_EXPECT(timer.duration<microseconds>() >= microseconds(1500));
+    ZEN_EXPECT(timer.duration<seconds>()      <  seconds(5));
+    ZEN_EXPECT(timer.elapsed<nanoseconds>()   >= timer.duration<nanoseconds>());
+
+    // Consecutive readings never go backwards, whichever clock is behind it
+    const auto t0 = zen::tsc_clock::now();
+    const auto t1 = zen::tsc_clock::now();
+    ZEN_EXPECT(t1 >= t0);
+
+    ZEN_EXPECT(zen::tsc_clock::is_invariant() == (zen::tsc_clock::ticks_per_second() > 0));
+    ZEN_EXPECT(zen::tsc_clock::is_steady);
+}
+
+void test_measure_execution()
+{
+    BEGIN_SUBTEST;
+
+    using namespace std::chrono;
+
+    // Any callable works, including ones that can't be copied into an std::function
+    auto owned = std::make_unique<int>(0);
+    const auto once = zen::measure_execution([p = std::move(owned)] { ++*p; });
+    ZEN_EXPECT(once >= nanoseconds(0));
+
+    int calls = 0;
+    const auto avg = zen::measure_execution([&calls] { zen::do_not_optimize(++calls); }, 1000);
+    ZEN_EXPECT(calls == 1000);
+    ZEN_EXPECT(avg.count() >= 0.0);
+    ZEN_EXPECT((std::is_same_v<decltype(avg), const duration<double, std::nano>>));
+
+    const auto avg_us = zen::measure_execution<microseconds>([] { std::this_thread::sleep_for(milliseconds(1)); }, 2);
+    ZEN_EXPECT(avg_us.count() >= 1000.0);
+
+    const auto [result, d] = zen::measure_result([] { return std::string("result"); });
+    ZEN_EXPECT(result == "result");
+    ZEN_EXPECT((std::is_same_v<decltype(d), const nanoseconds>));
+}
+
 void main_test_timer()
 {
     BEGIN_TEST;
@@ -44,4 +92,7 @@ void main_test_timer()
             std::this_thread::sleep_for(ms20);
         });
     ZEN_EXPECT(zen::adaptive_duration(dur) != "20 milliseconds"); // flaky test: sometimes fails, but that's okay
-}
\ No newline at end of file
+
+    test_measure_execution();
+    test_tsc_timer();
+}
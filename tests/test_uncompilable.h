@@ -17,6 +17,11 @@ void main_test_uncompilable()
     //auto* _7 = new zen::set<int>;
     //auto* _8 = new zen::string;
 
+    // The following should not compile since sorted vectors
+    // of bool keys are rejected with a static assertion
+    //zen::flat_map<bool, int> _9;
+    //zen::flat_set<bool> _10;
+
     //std::map<std::string, double> mis = { {"30.0", 3.0} };
     //zen::point pq = *mis.begin();
 }
\ No newline at end of file
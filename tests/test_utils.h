@@ -55,11 +55,13 @@ void test_utils_to_string()
     std::vector<int>                           v       = { 1, 2, 3 };
     std::vector<std::array<int, 2>>            va      = { {1, 2}, {3, 4} };
     std::vector<int>                           vempty;
+    std::forward_list<int>                     fl      = { 1, 2, 3 }; // no size(), estimated without walking it
 
     ZEN_EXPECT(zen::to_string()                  == "");
     ZEN_EXPECT(zen::to_string(1, 2, 3)           == "1 2 3");
     ZEN_EXPECT(zen::to_string(42.24)             == "42.24");
     ZEN_EXPECT(zen::to_string("hello")           == "hello");
+    ZEN_EXPECT(zen::to_string(std::string_view("hello")) == "hello");
     ZEN_EXPECT(zen::to_string(v)                 == "[1, 2, 3]");
     ZEN_EXPECT(zen::to_string(vempty)            == "[]");
     ZEN_EXPECT(zen::to_string(1, 42.24, "hello") == "1 42.24 hello");
@@ -69,8 +71,21 @@ void test_utils_to_string()
     ZEN_EXPECT(zen::to_string(vx)                == "[[1, 2], [3, 4]]");
     ZEN_EXPECT(zen::to_string(xv)                == "[[1, 2], [3, 4]]");
     ZEN_EXPECT(zen::to_string(va)                == "[[1, 2], [3, 4]]");
+    ZEN_EXPECT(zen::to_string(fl)                == "[1, 2, 3]");
     ZEN_EXPECT(zen::to_string(vvv)               == "[[[1, 2], [3, 4]], [[5, 6], [7, 8]]]");
     ZEN_EXPECT(zen::to_string(v, "mixed", 42)    == "[1, 2, 3] mixed 42");
+
+    // Numbers must read exactly as they would through std::ostream
+    ZEN_EXPECT(zen::to_string(1.0 / 3)           == "0.333333");
+    ZEN_EXPECT(zen::to_string(1e20)              == "1e+20");
+    ZEN_EXPECT(zen::to_string(100.0)             == "100");
+    ZEN_EXPECT(zen::to_string(-2.5f)             == "-2.5");
+    ZEN_EXPECT(zen::to_string(-42LL)             == "-42");
+    ZEN_EXPECT(zen::to_string('z', true, false)  == "z 1 0");
+
+    std::string s = "v = ";
+    zen::to_string_into(s, vv);
+    ZEN_EXPECT(s == "v = [[1, 2], [3, 4]]");
 }
 
 void test_utils_print()
@@ -139,6 +154,66 @@ void test_utils_print()
     ZEN_EXPECT(silent_print(ttpp) == "[1, 2, [0, [[\"tuplestr A\", \"tuplestr B\"], 7], 0], 3.9]");
 }
 
+// Only printable by reference: print() and log() must not copy their arguments
+struct uncopyable_printable {
+    uncopyable_printable() = default;
+    uncopyable_printable(const uncopyable_printable&) = delete;
+    friend std::ostream& operator<<(std::ostream& os, const uncopyable_printable&) { return os << "uncopyable"; }
+};
+
+void test_utils_format()
+{
+    BEGIN_SUBTEST;
+
+    const uncopyable_printable u;
+    ZEN_EXPECT(silent_print(u, 1) == "uncopyable 1");
+
+    ZEN_EXPECT(zen::format("no placeholders")               == "no placeholders");
+    ZEN_EXPECT(zen::format("{} + {} = {}", 1, 2, 3)         == "1 + 2 = 3");
+    ZEN_EXPECT(zen::format("{}:{}", "key", std::vector{1, 2}) == "key:[1, 2]");
+    ZEN_EXPECT(zen::format("{{{}}}", 42)                    == "{42}");
+    ZEN_EXPECT(zen::format("{} {}", u, 2.5)                 == "uncopyable 2.5");
+    ZEN_EXPECT(zen::internal::count_placeholders("{} {{}} {}") == 2);
+    // zen::format("{} {}", 1); // should fail compilation: FORMAT PLACEHOLDER COUNT DOES NOT MATCH THE NUMBER OF ARGUMENTS
+}
+
+void test_utils_timestamp()
+{
+    BEGIN_SUBTEST;
+
+    const std::string classic = zen::timestamp();
+    ZEN_EXPECT(classic.size() == 24); // Www Mmm dd hh:mm:ss yyyy
+    ZEN_EXPECT(classic[3] == ' ' && classic[13] == ':' && classic[16] == ':');
+
+    const std::regex iso(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2})");
+    ZEN_EXPECT(std::regex_match(zen::timestamp(zen::timestamp_format::iso8601), iso));
+
+    const std::regex iso_ms(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3})");
+    ZEN_EXPECT(std::regex_match(zen::timestamp(zen::timestamp_format::iso8601_ms), iso_ms));
+
+    const std::regex iso_us(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{6})");
+    ZEN_EXPECT(std::regex_match(std::string(zen::timestamp_view(zen::timestamp_format::iso8601_us)), iso_us));
+
+    // Switching formats within the same second must not reuse the other format's cache
+    ZEN_EXPECT(zen::timestamp(zen::timestamp_format::iso8601).size() == 19);
+    ZEN_EXPECT(zen::timestamp().size() == 24);
+
+    // Threads format into buffers of their own
+    std::vector<std::thread> threads;
+    std::atomic<int> well_formed{ 0 };
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            bool ok = true;
+            for (int i = 0; i < 1000; ++i)
+                ok = ok && std::regex_match(std::string(zen::timestamp_view(zen::timestamp_format::iso8601_us)), iso_us);
+            well_formed += ok;
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    ZEN_EXPECT(well_formed == 4);
+}
+
 void test_utils_search_upward()
 {
     BEGIN_SUBTEST;
@@ -199,5 +274,7 @@ void main_test_utils()
     test_utils_search_upward();
     test_utils_to_string();
     test_utils_print();
+    test_utils_format();
+    test_utils_timestamp();
     test_utils_sum();
 }
\ No newline at end of file
@@ -14,6 +14,67 @@ void test_vector_of_strings()
     ZEN_EXPECT(zen::is_empty(v) == v.is_empty());
 }
 
+template<class T>
+void test_vector_search_of()
+{
+    // Lengths around the vector widths, so matches land in full blocks as well as in the tails
+    for (int n : { 0, 1, 7, 16, 31, 33, 64, 129, 1000 }) {
+        zen::vector<T> v(n, T(1));
+        for (int i = 0; i < n; ++i) {
+            v[i] = T(2);
+            if (!v.contains(T(2)) || v.index_of(T(2)) != std::size_t(i) || v.count(T(2)) != 1 || !v.contains(zen::exec::par, T(2)))
+                ZEN_EXPECT(!"SEARCH MISSED AN ELEMENT");
+            v[i] = T(1);
+        }
+        ZEN_EXPECT(!v.contains(T(2)) && !v.index_of(T(2)) && v.count(T(1)) == std::size_t(n));
+    }
+}
+
+void test_vector_search()
+{
+    BEGIN_SUBTEST;
+    test_vector_search_of<char>();
+    test_vector_search_of<std::int16_t>();
+    test_vector_search_of<unsigned>();
+    test_vector_search_of<std::int64_t>();
+    test_vector_search_of<float>();
+    test_vector_search_of<double>();
+
+    // 64-bit values that only differ in one half
+    zen::vector<std::uint64_t> u(40, 0x1'0000'0002);
+    ZEN_EXPECT(!u.contains(0x2) && !u.contains(0x1'0000'0000) && u.count(0x1'0000'0002) == 40);
+
+    // Floating point equality: 0.0 matches -0.0, NaN matches nothing
+    zen::vector<double> d = { 1.5, -0.0, std::nan(""), 3 };
+    ZEN_EXPECT(d.contains(0.0) && d.index_of(0.0) == 1);
+    ZEN_EXPECT(!d.contains(std::nan("")) && d.count(std::nan("")) == 0);
+
+    zen::vector<int> v;
+    for (int i = 0; i < 100; ++i)
+        v.push_back(i * 3);
+    ZEN_EXPECT( v.contains_any({ 1, 2, 297 }));
+    ZEN_EXPECT(!v.contains_any({ 1, 2, 298 }));
+    ZEN_EXPECT(!v.contains_any(std::vector<int>{}));
+    ZEN_EXPECT( v.contains_any(std::vector<int>{ 1, 2, 4, 5, 7, 8, 10, 11, 13, 14, 297 })); // more than one pass takes
+    ZEN_EXPECT(!v.contains_any(std::vector<int>{ 1, 2, 4, 5, 7, 8, 10, 11, 13, 14, 298 }));
+
+    // Values the elements can't hold find nothing, rather than what they'd wrap or round to
+    zen::vector<std::uint8_t> bytes = { 44, 255, 7 };
+    ZEN_EXPECT(!bytes.contains_any(std::vector<int>{ 300, -1 }) && bytes.contains_any(std::vector<int>{ 300, 7 }));
+    ZEN_EXPECT(!bytes.contains_any(std::vector<int>{ 300, 301, 302, 303, 304, 305, 306, 307, 308, -1 }));
+    ZEN_EXPECT(!bytes.contains_any(std::vector<double>{ 44.5, 1e300, -1e300, 255.0 + 256 }));
+    zen::vector<float> floats = { 0.5f, 0.1f };
+    ZEN_EXPECT(!floats.contains_any(std::vector<double>{ 0.1, 1e300 }) && floats.contains_any(std::vector<double>{ 0.5 }));
+
+    // std::vector<bool> stores bits, not bools: its searches walk iterators instead
+    zen::vector<bool> flags = { false, false, true, false };
+    ZEN_EXPECT(flags.contains(true) && flags.index_of(true) == 2 && flags.count(false) == 3);
+    ZEN_EXPECT(flags.contains(zen::exec::par, true) && flags.contains_any({ true }) && !zen::vector<bool>(5, false).contains(true));
+
+    zen::vector<zen::string> s = { "a", "b", "a" };
+    ZEN_EXPECT(s.count("a") == 2 && s.index_of("b") == 1 && s.contains_any(std::vector<zen::string>{ "c", "b" }));
+}
+
 void main_test_vector()
 {
     BEGIN_TEST;
@@ -25,4 +86,5 @@ void main_test_vector()
     ZEN_EXPECT(zen::is_empty(v) == v.is_empty());
 
     test_vector_of_strings();
+    test_vector_search();
 }
\ No newline at end of file
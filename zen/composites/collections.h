@@ -30,13 +30,29 @@ namespace zen {
 // pretty much all C++ projects that use the types on the right.
 // The name 'composites' is chosen by analogy with composite materials.
 
+// Define ZEN_HASH_MAP_FLAT as 1 before including Kaizen to make hash_map and hash_set the
+// open-addressing flat_hash_map and flat_hash_set: faster and smaller, but their iterators and
+// references don't survive insertions. Or pick one per use with basic_hash_map/basic_hash_set.
+#ifndef ZEN_HASH_MAP_FLAT
+#define ZEN_HASH_MAP_FLAT 0
+#endif
+
 template<
+    bool Flat,
     class T,
     class H = std::hash<T>,
     class E = std::equal_to<T>,
     class A = std::allocator<T>
 >
-using hash_set = zen::unordered_set<T, H, E, A>;
+using basic_hash_set = std::conditional_t<Flat, zen::flat_hash_set<T, H, E, A>, zen::unordered_set<T, H, E, A>>;
+
+template<
+    class T,
+    class H = std::hash<T>,
+    class E = std::equal_to<T>,
+    class A = std::allocator<T>
+>
+using hash_set = basic_hash_set<ZEN_HASH_MAP_FLAT, T, H, E, A>;
 
 template<
     class T,
@@ -47,13 +63,23 @@ template<
 using hash_multiset = zen::unordered_multiset<T, H, E, A>;
 
 template<
+    bool Flat,
     class K,
     class V,
     class H = std::hash<K>,
     class E = std::equal_to<K>,
     class A = std::allocator<std::pair<const K, V>>
 >
-using hash_map = zen::unordered_map<K, V, H, E, A>;
+using basic_hash_map = std::conditional_t<Flat, zen::flat_hash_map<K, V, H, E, A>, zen::unordered_map<K, V, H, E, A>>;
+
+template<
+    class K,
+    class V,
+    class H = std::hash<K>,
+    class E = std::equal_to<K>,
+    class A = std::allocator<std::pair<const K, V>>
+>
+using hash_map = basic_hash_map<ZEN_HASH_MAP_FLAT, K, V, H, E, A>;
 
 template<
     class K,
@@ -80,4 +106,15 @@ using strings    = stringvec;
 using points     = points2d;
 using ints       = integers;
 
+// Small composite names: up to 8 elements without a heap allocation
+using small_stringvec = zen::small_vector<zen::string>;
+using small_integers  = zen::small_vector<int>;
+using small_floats    = zen::small_vector<float>;
+using small_reals     = zen::small_vector<double>;
+using small_points2d  = zen::small_vector<zen::point2d>;
+using small_points3d  = zen::small_vector<zen::point3d>;
+using small_strings   = small_stringvec;
+using small_points    = small_points2d;
+using small_ints      = small_integers;
+
 } // namespace zen
\ No newline at end of file
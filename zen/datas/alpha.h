@@ -22,7 +22,12 @@
 
 #pragma once
 
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <chrono>
 #include <queue>
+#include <ctime>
 
 namespace zen {
 
@@ -39,10 +44,66 @@ namespace zen {
 // Result:  "/path/to/file" does not exist
 inline std::string quote(const std::string_view s) { return '\"' + std::string(s) + '\"'; }
 
-inline auto timestamp() {
-    std::time_t result  = std::time(nullptr);
-    std::string timestr = std::asctime(std::localtime(&result));
-    return timestr.substr(0, timestr.length() - 1);
+// Layouts of zen::timestamp(), all in local time
+enum class timestamp_format {
+    classic,    // Wed May  1 12:34:56 2024, like std::asctime() without the newline
+    iso8601,    // 2024-05-01T12:34:56
+    iso8601_ms, // 2024-05-01T12:34:56.789
+    iso8601_us  // 2024-05-01T12:34:56.789012
+};
+
+// The current local time as a view into a per-thread buffer that stays valid until the same
+// thread calls it again. Unlike std::asctime(std::localtime()), which share static buffers,
+// this is thread-safe. The date and time of day are only formatted (with the timezone lookup
+// that involves) once per second per thread; other calls just rewrite the fractional digits.
+// Example: zen::timestamp_view(zen::timestamp_format::iso8601_ms);
+// Result:  "2024-05-01T12:34:56.789"
+inline std::string_view timestamp_view(timestamp_format format = timestamp_format::classic) {
+    struct cache {
+        std::int64_t     second = -1;
+        timestamp_format format = timestamp_format::classic;
+        std::size_t      prefix = 0;  // length of the cached part that lasts the whole second
+        char             text[48] = {};
+    };
+    thread_local cache c;
+
+    const auto now  = std::chrono::system_clock::now();
+    const auto secs = std::chrono::floor<std::chrono::seconds>(now);
+
+    if (secs.time_since_epoch().count() != c.second || format != c.format) {
+        const std::time_t t = std::chrono::system_clock::to_time_t(secs);
+        std::tm tm{};
+#if defined(_WIN32)
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        const char* layout = format == timestamp_format::classic ? "%a %b %e %H:%M:%S %Y" : "%Y-%m-%dT%H:%M:%S";
+        c.prefix = std::strftime(c.text, sizeof(c.text), layout, &tm);
+        c.second = secs.time_since_epoch().count();
+        c.format = format;
+    }
+
+    int digits = 0;
+    if (format == timestamp_format::iso8601_ms) digits = 3;
+    if (format == timestamp_format::iso8601_us) digits = 6;
+    if (digits == 0)
+        return std::string_view(c.text, c.prefix);
+
+    auto fraction = std::chrono::duration_cast<std::chrono::microseconds>(now - secs).count();
+    if (digits == 3)
+        fraction /= 1000;
+    c.text[c.prefix] = '.';
+    for (int i = digits; i > 0; --i, fraction /= 10)
+        c.text[c.prefix + i] = static_cast<char>('0' + fraction % 10);
+    return std::string_view(c.text, c.prefix + 1 + digits);
+}
+
+// Same as timestamp_view(), as a string of its own
+// Example: zen::timestamp();
+// Result:  "Wed May  1 12:34:56 2024"
+inline std::string timestamp(timestamp_format format = timestamp_format::classic) {
+    return std::string(timestamp_view(format));
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////// SERIALIZATION
@@ -27,13 +27,14 @@
 #include <array>
 
 #include "alpha.h" // internal; will not be included in kaizen.h
+#include "simd.h"  // internal; will not be included in kaizen.h
 
 namespace zen {
 
 ///////////////////////////////////////////////////////////////////////////////////////////// zen::array
 
 template<class T, size_t N>
-class array : public std::array<T, N>, private zen::stackonly
+class array : public std::array<T, N>, public internal::searchable<array<T, N>, T>, private zen::stackonly
 {
 public:
     using std::array<T, N>::array; // inherit constructors, has to be explicit
@@ -44,14 +45,6 @@ public:
         std::copy(std::begin(init_list), std::end(init_list), my::begin());
     }
 
-    template<class Pred>
-    typename std::enable_if<std::is_invocable_r<bool, Pred, const T&>::value, bool>::type
-        contains(Pred p) const
-    {
-        return std::find_if(my::begin(), my::end(), p) != my::end();
-    }
-    bool contains(const T& x) const { return std::find(my::begin(), my::end(), x) != my::end(); }
-
     bool is_empty() const { return my::empty(); }
 
 private:
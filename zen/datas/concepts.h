@@ -23,6 +23,8 @@
 #pragma once
 
 #include <iterator>
+#include <string>
+#include <string_view>
 
 namespace zen {
 
@@ -131,6 +133,7 @@ namespace zen {
 template<class T>
 constexpr bool is_string_like() {
     return std::is_convertible<T, std::string>::value
+        || std::is_convertible<T, std::string_view>::value
         || std::is_convertible<T, const char*>::value;
 }
 
@@ -0,0 +1,276 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <shared_mutex>
+#include <functional>
+#include <algorithm>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+#include "alpha.h"         // internal; will not be included in kaizen.h
+#include "unordered_map.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::concurrent_hash_map
+
+// A hash map that many threads can use at once. Keys are spread over independently locked
+// shards, each a zen::unordered_map behind a std::shared_mutex, so threads working on keys in
+// different shards never wait for one another and readers of the same shard share its lock.
+// Nothing hands out references into the map: lookups copy the value out, and updates run
+// a callback under the shard's lock. Callbacks must not call back into the same map.
+// Example: zen::concurrent_hash_map<zen::string, long long, zen::string_hash> hits;
+//          hits.upsert("GET /", [](long long& n) { ++n; }); // from any thread
+//          hits.find("GET /")  // std::optional<long long>
+// A reader-writer lock costs more than a plain one, so for write-mostly maps (counters
+// bumped far more often than read) basic_concurrent_hash_map<std::mutex, ...> may do better.
+template<
+    class M, // std::shared_mutex, or any mutex: without lock_shared(), reads lock exclusively
+    class K,
+    class V,
+    class H = std::hash<K>,
+    class E = std::equal_to<K>,
+    class A = std::allocator<std::pair<const K, V>>
+>
+class basic_concurrent_hash_map
+{
+public:
+    using key_type    = K;
+    using mapped_type = V;
+    using value_type  = std::pair<const K, V>;
+    using size_type   = std::size_t;
+    using map_type    = zen::unordered_map<K, V, H, E, A>;
+
+    // The number of shards is rounded up to a power of two; by default it's a few per hardware thread
+    explicit basic_concurrent_hash_map(size_type shards = default_shard_count())
+        : shard_count_(round_up(shards)), shards_(new shard[shard_count_]) {}
+
+    basic_concurrent_hash_map(std::initializer_list<value_type> items, size_type shards = default_shard_count())
+        : basic_concurrent_hash_map(shards)
+    {
+        for (const auto& [k, v] : items)
+            insert(k, v);
+    }
+
+    basic_concurrent_hash_map(const basic_concurrent_hash_map&) = delete;
+    basic_concurrent_hash_map& operator=(const basic_concurrent_hash_map&) = delete;
+
+    // A copy of the value of key, if it's in the map
+    std::optional<V> find(const K& key) const {
+        const shard& s = shard_of(key);
+        read_lock lock(s.mutex);
+        const auto it = s.map.find(key);
+        if (it == s.map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    // Calls f(const V&) on the value of key under a shared lock, without copying it;
+    // returns whether key was found
+    template<class F>
+    bool visit(const K& key, F&& f) const {
+        const shard& s = shard_of(key);
+        read_lock lock(s.mutex);
+        const auto it = s.map.find(key);
+        if (it == s.map.end())
+            return false;
+        std::forward<F>(f)(std::as_const(it->second));
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        const shard& s = shard_of(key);
+        read_lock lock(s.mutex);
+        return s.map.find(key) != s.map.end();
+    }
+
+    // Inserts key if it isn't in the map yet; returns whether it did
+    template<class... Args>
+    bool insert(const K& key, Args&&... args) {
+        shard& s = shard_of(key);
+        std::unique_lock lock(s.mutex);
+        return s.map.try_emplace(key, std::forward<Args>(args)...).second;
+    }
+
+    // Returns true if key was inserted, false if its value was replaced
+    template<class U>
+    bool insert_or_assign(const K& key, U&& value) {
+        shard& s = shard_of(key);
+        std::unique_lock lock(s.mutex);
+        return s.map.insert_or_assign(key, std::forward<U>(value)).second;
+    }
+
+    // Calls f(V&) on the value of key, value-initializing it first if key isn't in the map
+    // yet, all under the shard's lock, so read-modify-write updates don't race;
+    // returns whether key was inserted
+    // Example: counts.upsert(word, [](int& n) { ++n; });
+    template<class F>
+    bool upsert(const K& key, F&& f) {
+        shard& s = shard_of(key);
+        std::unique_lock lock(s.mutex);
+        const auto [it, inserted] = s.map.try_emplace(key);
+        std::forward<F>(f)(it->second);
+        return inserted;
+    }
+
+    bool erase(const K& key) {
+        shard& s = shard_of(key);
+        std::unique_lock lock(s.mutex);
+        return s.map.erase(key) > 0;
+    }
+
+    // Erases the items for which pred(const value_type&) holds, a shard at a time;
+    // returns how many it erased
+    template<class P>
+    size_type erase_if(P pred) {
+        size_type erased = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::unique_lock lock(shards_[i].mutex);
+            auto& map = shards_[i].map;
+            for (auto it = map.begin(); it != map.end();) {
+                if (pred(std::as_const(*it))) {
+                    it = map.erase(it);
+                    ++erased;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return erased;
+    }
+
+    // Calls f(const value_type&) on every item of a consistent snapshot: all shards are
+    // read-locked together for the duration, so f sees the map exactly as it was at one
+    // instant, but writers wait until f is done with all of it. Keep f short, or take a
+    // snapshot() and walk it instead.
+    template<class F>
+    void for_each(F f) const {
+        const auto locks = lock_all();
+        for (size_type i = 0; i < shard_count_; ++i)
+            for (const auto& item : shards_[i].map)
+                f(item);
+    }
+
+    // A consistent copy of the whole map
+    map_type snapshot() const {
+        const auto locks = lock_all();
+        size_type n = 0;
+        for (size_type i = 0; i < shard_count_; ++i)
+            n += shards_[i].map.size();
+        map_type copy;
+        copy.reserve(n);
+        for (size_type i = 0; i < shard_count_; ++i)
+            copy.insert(shards_[i].map.begin(), shards_[i].map.end());
+        return copy;
+    }
+
+    // Consistent too, so it locks every shard: not something for a hot path
+    size_type size() const {
+        const auto locks = lock_all();
+        size_type n = 0;
+        for (size_type i = 0; i < shard_count_; ++i)
+            n += shards_[i].map.size();
+        return n;
+    }
+
+    bool empty()    const { return size() == 0; }
+    bool is_empty() const { return size() == 0; }
+
+    void clear() {
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::unique_lock lock(shards_[i].mutex);
+            shards_[i].map.clear();
+        }
+    }
+
+    size_type shard_count() const { return shard_count_; }
+
+    static size_type default_shard_count() {
+        return round_up(4 * std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+private:
+    template<class Mutex, class = void>
+    struct has_lock_shared : std::false_type {};
+
+    template<class Mutex>
+    struct has_lock_shared<Mutex, std::void_t<decltype(std::declval<Mutex&>().lock_shared())>> : std::true_type {};
+
+    using read_lock = std::conditional_t<has_lock_shared<M>::value, std::shared_lock<M>, std::unique_lock<M>>;
+
+    // A cache line each, so locking one shard doesn't slow down its neighbours
+    struct alignas(64) shard {
+        mutable M mutex;
+        map_type  map;
+    };
+
+    static size_type round_up(size_type n) {
+        size_type count = 1;
+        while (count < n)
+            count *= 2;
+        return count;
+    }
+
+    // std::hash of integers is usually the identity: mix it, and take the high bits, where
+    // the mixing is best, so runs of keys spread over all the shards
+    size_type shard_index(const K& key) const {
+        const std::uint64_t h = static_cast<std::uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ull;
+        return static_cast<size_type>(h >> 40) & (shard_count_ - 1);
+    }
+
+    shard&       shard_of(const K& key)       { return shards_[shard_index(key)]; }
+    const shard& shard_of(const K& key) const { return shards_[shard_index(key)]; }
+
+    // Always taken in shard order, and writers only ever hold one, so this can't deadlock
+    std::vector<read_lock> lock_all() const {
+        std::vector<read_lock> locks;
+        locks.reserve(shard_count_);
+        for (size_type i = 0; i < shard_count_; ++i)
+            locks.emplace_back(shards_[i].mutex);
+        return locks;
+    }
+
+    size_type                shard_count_;
+    std::unique_ptr<shard[]> shards_;
+    H                        hash_;
+};
+
+template<
+    class K,
+    class V,
+    class H = std::hash<K>,
+    class E = std::equal_to<K>,
+    class A = std::allocator<std::pair<const K, V>>
+>
+using concurrent_hash_map = basic_concurrent_hash_map<std::shared_mutex, K, V, H, E, A>;
+
+} // namespace zen
@@ -0,0 +1,351 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::spsc_queue
+
+// Bounded lock-free queues for passing elements between threads, in place of a zen::queue
+// behind a mutex. Their capacity is rounded up to a power of two. try_push()/try_pop() never
+// block and return false when the queue is full/empty; wait_push()/wait_pop() block until they
+// can proceed, sleeping in std::atomic::wait (C++20) rather than spinning where it's available.
+
+namespace internal {
+    // Raw storage for one element
+    template<class T>
+    struct alignas(T) queue_slot {
+        unsigned char bytes[sizeof(T)];
+
+        T*   get() { return std::launder(reinterpret_cast<T*>(bytes)); }
+        void* raw() { return bytes; }
+    };
+
+    inline std::size_t queue_capacity(std::size_t n) {
+        if (n == 0)
+            throw std::invalid_argument("QUEUE CAPACITY MUST BE POSITIVE");
+        std::size_t capacity = 1;
+        while (capacity < n)
+            capacity *= 2;
+        return capacity;
+    }
+
+    // Blocks while a == old (or yields once where atomic waiting is unavailable)
+    template<class U>
+    void wait_while_equal(const std::atomic<U>& a, U old) {
+#if defined(__cpp_lib_atomic_wait)
+        a.wait(old, std::memory_order_acquire);
+#else
+        if (a.load(std::memory_order_acquire) == old)
+            std::this_thread::yield();
+#endif
+    }
+
+    // Yields for the first few tries, since the other side is usually about to move, and
+    // only then goes to sleep
+    template<class U>
+    void backoff(int tries, const std::atomic<U>& a, U old) {
+        if (tries < 16)
+            std::this_thread::yield();
+        else
+            wait_while_equal(a, old);
+    }
+
+    template<class U>
+    void notify_waiters(std::atomic<U>& a) {
+#if defined(__cpp_lib_atomic_wait)
+        a.notify_all();
+#else
+        (void)a;
+#endif
+    }
+} // namespace internal
+
+// Single producer, single consumer: one thread pushes, one thread pops. Each index is written by
+// one thread only, sits on a cache line of its own, and each side keeps a cached copy of the other
+// side's index, so most operations touch no shared cache line at all.
+template<class T>
+class spsc_queue
+{
+public:
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    explicit spsc_queue(size_type capacity = 1024)
+        : slots_(new internal::queue_slot<T>[internal::queue_capacity(capacity)]),
+          mask_(internal::queue_capacity(capacity) - 1) {}
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::uint64_t i = head_.load(); i != tail_.load(); ++i)
+                slots_[i & mask_].get()->~T();
+        }
+    }
+
+    // Producer side
+    bool try_push(const T& x) { return try_emplace(x); }
+    bool try_push(T&& x)      { return try_emplace(std::move(x)); }
+
+    template<class... Args>
+    bool try_emplace(Args&&... args) {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false;
+        }
+        ::new (slots_[tail & mask_].raw()) T(std::forward<Args>(args)...);
+        publish(tail_, tail + 1);
+        return true;
+    }
+
+    void wait_push(T x) {
+        for (int tries = 0; !try_push(std::move(x)); ++tries)
+            internal::backoff(tries, head_, head_cache_);
+    }
+
+    // Pushes as many of the n elements from first as there is room for, publishing them at
+    // once; returns how many it pushed
+    template<class It>
+    size_type push_n(It first, size_type n) {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        head_cache_ = head_.load(std::memory_order_acquire);
+        const size_type room = static_cast<size_type>(mask_ + 1 - (tail - head_cache_));
+        const size_type k = n < room ? n : room;
+        for (size_type i = 0; i < k; ++i, ++first)
+            ::new (slots_[(tail + i) & mask_].raw()) T(*first);
+        if (k)
+            publish(tail_, tail + k);
+        return k;
+    }
+
+    // Consumer side
+    bool try_pop(T& out) {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        T* x = slots_[head & mask_].get();
+        out = std::move(*x);
+        x->~T();
+        publish(head_, head + 1);
+        return true;
+    }
+
+    void wait_pop(T& out) {
+        for (int tries = 0; !try_pop(out); ++tries)
+            internal::backoff(tries, tail_, tail_cache_);
+    }
+
+    // Pops up to n elements into out, freeing their room at once; returns how many it popped
+    template<class OutIt>
+    size_type pop_n(OutIt out, size_type n) {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        const size_type ready = static_cast<size_type>(tail_cache_ - head);
+        const size_type k = n < ready ? n : ready;
+        for (size_type i = 0; i < k; ++i, ++out) {
+            T* x = slots_[(head + i) & mask_].get();
+            *out = std::move(*x);
+            x->~T();
+        }
+        if (k)
+            publish(head_, head + k);
+        return k;
+    }
+
+    // Approximate while the other side is active. The head is read first: the tail read after
+    // it can only be further ahead, never behind, so the difference can't wrap around
+    size_type size() const {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+        return static_cast<size_type>(std::min<std::uint64_t>(tail - head, mask_ + 1));
+    }
+
+    bool      empty()    const { return size() == 0; }
+    bool      is_empty() const { return size() == 0; }
+    size_type capacity() const { return mask_ + 1; }
+
+private:
+    static void publish(std::atomic<std::uint64_t>& index, std::uint64_t value) {
+        index.store(value, std::memory_order_release);
+        internal::notify_waiters(index);
+    }
+
+    std::unique_ptr<internal::queue_slot<T>[]> slots_;
+    const std::uint64_t mask_;
+    alignas(64) std::atomic<std::uint64_t> tail_{0};  // written by the producer
+    std::uint64_t head_cache_ = 0;                     // producer only
+    alignas(64) std::atomic<std::uint64_t> head_{0};  // written by the consumer
+    std::uint64_t tail_cache_ = 0;                     // consumer only
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::mpmc_queue
+
+// Multiple producers, multiple consumers, after Dmitry Vyukov's bounded MPMC queue: every slot
+// has a sequence number that says whose turn it is (a producer's for lap n, or a consumer's),
+// so threads claim a position with a single compare-and-swap and never wait on one another
+// except when the queue is full or empty.
+template<class T>
+class mpmc_queue
+{
+public:
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    explicit mpmc_queue(size_type capacity = 1024)
+        : cells_(new cell[internal::queue_capacity(capacity)]),
+          mask_(internal::queue_capacity(capacity) - 1)
+    {
+        for (std::uint64_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::uint64_t i = dequeue_.load(); i != enqueue_.load(); ++i)
+                cells_[i & mask_].slot.get()->~T();
+        }
+    }
+
+    bool try_push(const T& x) { return try_emplace(x); }
+    bool try_push(T&& x)      { return try_emplace(std::move(x)); }
+
+    template<class... Args>
+    bool try_emplace(Args&&... args) {
+        std::uint64_t pos = enqueue_.load(std::memory_order_relaxed);
+        cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::uint64_t seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - pos);
+            if (diff == 0) { // the slot is free for this lap: claim it
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) { // the consumer of the previous lap isn't done: full
+                return false;
+            } else { // another producer got there first
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (c->slot.raw()) T(std::forward<Args>(args)...);
+        c->sequence.store(pos + 1, std::memory_order_release);
+        internal::notify_waiters(enqueue_);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        std::uint64_t pos = dequeue_.load(std::memory_order_relaxed);
+        cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::uint64_t seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) { // not written yet: empty
+                return false;
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+        T* x = c->slot.get();
+        out = std::move(*x);
+        x->~T();
+        c->sequence.store(pos + mask_ + 1, std::memory_order_release); // free for the next lap
+        internal::notify_waiters(dequeue_);
+        return true;
+    }
+
+    // The waits sleep until the position on the other side moves. A position is claimed
+    // just before its slot is written, so a woken thread may briefly find nothing to take.
+    void wait_push(T x) {
+        for (int tries = 0;; ++tries) {
+            const std::uint64_t dequeued = dequeue_.load(std::memory_order_acquire);
+            if (try_push(std::move(x)))
+                return;
+            if (enqueue_.load(std::memory_order_relaxed) - dequeued > mask_)
+                internal::backoff(tries, dequeue_, dequeued);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void wait_pop(T& out) {
+        for (int tries = 0;; ++tries) {
+            const std::uint64_t enqueued = enqueue_.load(std::memory_order_acquire);
+            if (try_pop(out))
+                return;
+            if (enqueued == dequeue_.load(std::memory_order_relaxed))
+                internal::backoff(tries, enqueue_, enqueued);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // Approximate while other threads are active
+    size_type size() const {
+        const std::uint64_t dequeued = dequeue_.load(std::memory_order_acquire);
+        const std::uint64_t enqueued = enqueue_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? static_cast<size_type>(enqueued - dequeued) : 0;
+    }
+
+    bool      empty()    const { return size() == 0; }
+    bool      is_empty() const { return size() == 0; }
+    size_type capacity() const { return mask_ + 1; }
+
+private:
+    struct cell {
+        std::atomic<std::uint64_t> sequence;
+        internal::queue_slot<T>    slot;
+    };
+
+    std::unique_ptr<cell[]> cells_;
+    const std::uint64_t mask_;
+    alignas(64) std::atomic<std::uint64_t> enqueue_{0};
+    alignas(64) std::atomic<std::uint64_t> dequeue_{0};
+};
+
+} // namespace zen
@@ -0,0 +1,600 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <memory>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+#include "simd.h"  // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::flat_hash_map
+
+// Hash tables with open addressing in the style of Swiss tables: the elements live in one flat
+// array, next to an array of one control byte per slot (empty, deleted, or 7 bits of the hash of
+// the element there). A lookup compares the control bytes of a group of 16 slots at once with
+// SSE2 (a plain loop elsewhere) and only touches the elements whose 7 bits match: no allocation
+// per element and no pointer chasing, unlike the node-based zen::unordered_map.
+// Unlike std::unordered_map, inserting and erasing invalidates iterators and references.
+
+namespace internal {
+    using ctrl_t = signed char;
+
+    constexpr ctrl_t ctrl_empty   = -128;
+    constexpr ctrl_t ctrl_deleted = -2;   // tombstone: keeps probe sequences going through it
+
+    // Control bytes of 16 consecutive slots, as bit masks with one bit per slot
+    class ctrl_group {
+    public:
+        static constexpr std::size_t width = 16;
+
+#if defined(ZEN_HAS_SSE2)
+        explicit ctrl_group(const ctrl_t* p) : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+        std::uint32_t match(ctrl_t h2) const {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2))));
+        }
+
+        std::uint32_t match_empty() const { return match(ctrl_empty); }
+
+        std::uint32_t match_empty_or_deleted() const { // the only control bytes below -1
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(ctrl_, _mm_set1_epi8(-1))));
+        }
+
+    private:
+        __m128i ctrl_;
+#else
+        explicit ctrl_group(const ctrl_t* p) : ctrl_(p) {}
+
+        std::uint32_t match(ctrl_t h2) const {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < width; ++i)
+                mask |= std::uint32_t(ctrl_[i] == h2) << i;
+            return mask;
+        }
+
+        std::uint32_t match_empty() const { return match(ctrl_empty); }
+
+        std::uint32_t match_empty_or_deleted() const {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < width; ++i)
+                mask |= std::uint32_t(ctrl_[i] < -1) << i;
+            return mask;
+        }
+
+    private:
+        const ctrl_t* ctrl_;
+#endif
+    };
+
+    // Control bytes of a table with no slots: lookups see one group of empty slots
+    alignas(16) inline const ctrl_t empty_ctrl_group[ctrl_group::width] = {
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+    };
+
+    struct key_of_pair  { template<class P> const auto& operator()(const P& p) const { return p.first; } };
+    struct key_of_value { template<class K> const K&    operator()(const K& k) const { return k; } };
+
+    // The table behind zen::flat_hash_map and zen::flat_hash_set. Value is what the slots hold,
+    // KeyOf gets the key out of it. The capacity is a power of two and at least 16; the control
+    // array has 16 more bytes that repeat its first 16, so that a group can start at any slot.
+    template<class Value, class K, class KeyOf, class H, class E, class A>
+    class flat_hash_table {
+        using slot_allocator = typename std::allocator_traits<A>::template rebind_alloc<Value>;
+        using ctrl_allocator = typename std::allocator_traits<A>::template rebind_alloc<ctrl_t>;
+        using slot_traits    = std::allocator_traits<slot_allocator>;
+        using ctrl_traits    = std::allocator_traits<ctrl_allocator>;
+
+        static constexpr std::size_t width = ctrl_group::width;
+
+    public:
+        using key_type        = K;
+        using value_type      = Value;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher          = H;
+        using key_equal       = E;
+        using allocator_type  = A;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+        template<bool Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Value;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<Const, const Value&, Value&>;
+            using pointer           = std::conditional_t<Const, const Value*, Value*>;
+
+            basic_iterator() = default;
+            template<bool C = Const, class = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& it) : ctrl_(it.ctrl_), slot_(it.slot_), end_(it.end_) {}
+
+            reference operator*()  const { return *slot_; }
+            pointer   operator->() const { return  slot_; }
+
+            basic_iterator& operator++() { ++ctrl_; ++slot_; skip_free(); return *this; }
+            basic_iterator  operator++(int) { basic_iterator it = *this; ++*this; return it; }
+
+            friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.ctrl_ == b.ctrl_; }
+            friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return a.ctrl_ != b.ctrl_; }
+
+        private:
+            friend class flat_hash_table;
+            template<bool> friend class basic_iterator;
+
+            basic_iterator(const ctrl_t* ctrl, Value* slot, const ctrl_t* end) : ctrl_(ctrl), slot_(slot), end_(end) {}
+
+            void skip_free() {
+                while (ctrl_ != end_ && *ctrl_ < 0) {
+                    ++ctrl_;
+                    ++slot_;
+                }
+            }
+
+            const ctrl_t* ctrl_ = nullptr;
+            Value*        slot_ = nullptr;
+            const ctrl_t* end_  = nullptr;
+        };
+
+        // Elements of a set are keys and can't be modified in place
+        using iterator       = basic_iterator<std::is_same_v<Value, K>>;
+        using const_iterator = basic_iterator<true>;
+
+        flat_hash_table() = default;
+
+        explicit flat_hash_table(size_type n, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+            : hash_(hash), equal_(equal), slot_alloc_(alloc), ctrl_alloc_(alloc)
+        {
+            reserve(n);
+        }
+
+        template<class It>
+        flat_hash_table(It first, It last, size_type n = 0, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+            : flat_hash_table(n, hash, equal, alloc)
+        {
+            insert(first, last);
+        }
+
+        flat_hash_table(std::initializer_list<Value> init, size_type n = 0, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+            : flat_hash_table(init.begin(), init.end(), n ? n : init.size(), hash, equal, alloc) {}
+
+        flat_hash_table(const flat_hash_table& other)
+            : hash_(other.hash_), equal_(other.equal_),
+              slot_alloc_(slot_traits::select_on_container_copy_construction(other.slot_alloc_)),
+              ctrl_alloc_(ctrl_traits::select_on_container_copy_construction(other.ctrl_alloc_))
+        {
+            reserve(other.size());
+            for (const Value& v : other)
+                insert_unique(hash_of(KeyOf()(v)), v);
+        }
+
+        flat_hash_table(flat_hash_table&& other) noexcept
+            : ctrl_(std::exchange(other.ctrl_, empty_ctrl())), slots_(std::exchange(other.slots_, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0)),
+              growth_left_(std::exchange(other.growth_left_, 0)),
+              hash_(other.hash_), equal_(other.equal_), slot_alloc_(other.slot_alloc_), ctrl_alloc_(other.ctrl_alloc_) {}
+
+        flat_hash_table& operator=(flat_hash_table other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        flat_hash_table& operator=(std::initializer_list<Value> init) {
+            clear();
+            insert(init);
+            return *this;
+        }
+
+        ~flat_hash_table() { destroy(); }
+
+        iterator       begin()        { iterator it(ctrl_, slots_, ctrl_ + capacity_); it.skip_free(); return it; }
+        const_iterator begin()  const { const_iterator it(ctrl_, slots_, ctrl_ + capacity_); it.skip_free(); return it; }
+        const_iterator cbegin() const { return begin(); }
+        iterator       end()          { return iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_); }
+        const_iterator end()    const { return const_iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_); }
+        const_iterator cend()   const { return end(); }
+
+        bool      empty()    const { return size_ == 0; }
+        bool      is_empty() const { return size_ == 0; }
+        size_type size()     const { return size_; }
+        size_type max_size() const { return slot_traits::max_size(slot_alloc_); }
+
+        // Number of slots, of which up to 7/8 get filled before the table grows
+        size_type capacity()         const { return capacity_; }
+        size_type bucket_count()     const { return capacity_; }
+        float     load_factor()      const { return capacity_ ? float(size_) / float(capacity_) : 0.0f; }
+        float     max_load_factor()  const { return 0.875f; }
+
+        hasher         hash_function() const { return hash_; }
+        key_equal      key_eq()        const { return equal_; }
+        allocator_type get_allocator() const { return allocator_type(slot_alloc_); }
+
+        void clear() {
+            if (size_ == 0 && growth_left_ == capacity_ - capacity_ / 8)
+                return;
+            destroy_elements();
+            std::fill(ctrl_, ctrl_ + capacity_ + width, ctrl_empty);
+            size_ = 0;
+            growth_left_ = capacity_ - capacity_ / 8;
+        }
+
+        // Makes room for n elements without growing again
+        void reserve(size_type n) {
+            if (n > size_ + growth_left_)
+                resize(capacity_for(n));
+        }
+
+        void rehash(size_type n) { resize(capacity_for(std::max(n, size_))); }
+
+        std::pair<iterator, bool> insert(const Value& v) { return emplace_value(v); }
+        std::pair<iterator, bool> insert(Value&& v)      { return emplace_value(std::move(v)); }
+
+        template<class P, class = std::enable_if_t<std::is_constructible_v<Value, P&&>>>
+        std::pair<iterator, bool> insert(P&& v) { return emplace_value(Value(std::forward<P>(v))); }
+
+        template<class It>
+        void insert(It first, It last) {
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>)
+                reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+            for (; first != last; ++first)
+                emplace_value(*first);
+        }
+
+        void insert(std::initializer_list<Value> init) { insert(init.begin(), init.end()); }
+
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) { return emplace_value(Value(std::forward<Args>(args)...)); }
+
+        iterator       find(const K& key)       { return iterator_at(find_index(key)); }
+        const_iterator find(const K& key) const { return const_cast<flat_hash_table*>(this)->find(key); }
+
+        bool      contains(const K& key) const { return find_index(key) != capacity_; }
+        size_type count(const K& key)    const { return contains(key) ? 1 : 0; }
+
+        std::pair<iterator, iterator> equal_range(const K& key) {
+            iterator it = find(key);
+            return { it, it == end() ? it : std::next(it) };
+        }
+
+        size_type erase(const K& key) {
+            const size_type i = find_index(key);
+            if (i == capacity_)
+                return 0;
+            erase_at(i);
+            return 1;
+        }
+
+        iterator erase(const_iterator pos) {
+            const size_type i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+            erase_at(i);
+            iterator it(ctrl_ + i, slots_ + i, ctrl_ + capacity_);
+            it.skip_free();
+            return it;
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            while (first != last)
+                first = erase(first);
+            return iterator(const_cast<ctrl_t*>(last.ctrl_), last.slot_, last.end_);
+        }
+
+        void swap(flat_hash_table& other) noexcept {
+            using std::swap;
+            swap(ctrl_, other.ctrl_);
+            swap(slots_, other.slots_);
+            swap(capacity_, other.capacity_);
+            swap(size_, other.size_);
+            swap(growth_left_, other.growth_left_);
+            swap(hash_, other.hash_);
+            swap(equal_, other.equal_);
+            swap(slot_alloc_, other.slot_alloc_);
+            swap(ctrl_alloc_, other.ctrl_alloc_);
+        }
+
+        friend void swap(flat_hash_table& a, flat_hash_table& b) noexcept { a.swap(b); }
+
+    protected:
+        // std::hash of integers is usually the identity: mix all bits into both the 7 bits
+        // kept in the control bytes and the rest that picks where probing starts
+        std::size_t hash_of(const K& key) const {
+            std::uint64_t h = static_cast<std::uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ull;
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+
+        static ctrl_t      h2(std::size_t hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+        static std::size_t h1(std::size_t hash) { return hash >> 7; }
+
+        // Slot index of key, or capacity_ if it's not there
+        template<class Key>
+        size_type find_index(const Key& key, std::size_t hash) const {
+            const size_type mask = capacity_ ? capacity_ - 1 : 0;
+            size_type pos = h1(hash) & mask;
+            for (size_type step = width; ; step += width) { // triangular probing visits every group
+                const ctrl_group g(ctrl_ + pos);
+                for (std::uint32_t m = g.match(h2(hash)); m; m &= m - 1) {
+                    const size_type i = (pos + lowest_bit(m)) & mask;
+                    if (equal_(KeyOf()(slots_[i]), key))
+                        return i;
+                }
+                if (g.match_empty())
+                    return capacity_;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        size_type find_index(const K& key) const { return find_index(key, hash_of(key)); }
+
+        // First empty or deleted slot on the probe sequence of hash
+        size_type find_free(std::size_t hash) const {
+            const size_type mask = capacity_ - 1;
+            size_type pos = h1(hash) & mask;
+            for (size_type step = width; ; step += width) {
+                if (const std::uint32_t m = ctrl_group(ctrl_ + pos).match_empty_or_deleted())
+                    return (pos + lowest_bit(m)) & mask;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        // Inserts v, known not to be in the table yet, at the first free slot of its probe sequence
+        template<class... Args>
+        size_type insert_unique(std::size_t hash, Args&&... args) {
+            if (growth_left_ == 0)
+                grow();
+            size_type i = find_free(hash);
+            slot_traits::construct(slot_alloc_, slots_ + i, std::forward<Args>(args)...);
+            if (ctrl_[i] == ctrl_empty) // reusing a tombstone doesn't use up room
+                --growth_left_;
+            set_ctrl(i, h2(hash));
+            ++size_;
+            return i;
+        }
+
+        template<class V>
+        std::pair<iterator, bool> emplace_value(V&& v) {
+            const std::size_t hash = hash_of(KeyOf()(v));
+            const size_type found = find_index(KeyOf()(v), hash);
+            if (found != capacity_)
+                return { iterator_at(found), false };
+            return { iterator_at(insert_unique(hash, std::forward<V>(v))), true };
+        }
+
+        iterator iterator_at(size_type i) { return iterator(ctrl_ + i, slots_ + i, ctrl_ + capacity_); }
+
+        Value& slot(size_type i) { return slots_[i]; }
+
+        void erase_at(size_type i) {
+            slot_traits::destroy(slot_alloc_, slots_ + i);
+            set_ctrl(i, ctrl_deleted);
+            --size_;
+        }
+
+    private:
+        static ctrl_t* empty_ctrl() { return const_cast<ctrl_t*>(empty_ctrl_group); }
+
+        static size_type capacity_for(size_type n) {
+            if (n == 0)
+                return 0;
+            size_type capacity = width;
+            while (capacity - capacity / 8 < n)
+                capacity *= 2;
+            return capacity;
+        }
+
+        void set_ctrl(size_type i, ctrl_t c) {
+            ctrl_[i] = c;
+            if (i < width)
+                ctrl_[capacity_ + i] = c;
+        }
+
+        // Doubles the capacity, unless tombstones take up much of it: then rehashing in place frees them
+        void grow() {
+            if (capacity_ && size_ <= (capacity_ - capacity_ / 8) / 2)
+                resize(capacity_);
+            else
+                resize(capacity_ ? capacity_ * 2 : width);
+        }
+
+        void resize(size_type capacity) {
+            ctrl_t*         old_ctrl     = ctrl_;
+            Value*          old_slots    = slots_;
+            const size_type old_capacity = capacity_;
+
+            if (capacity == 0) {
+                ctrl_  = empty_ctrl();
+                slots_ = nullptr;
+            } else {
+                slots_ = slot_traits::allocate(slot_alloc_, capacity);
+                try {
+                    ctrl_ = ctrl_traits::allocate(ctrl_alloc_, capacity + width);
+                } catch (...) {
+                    slot_traits::deallocate(slot_alloc_, slots_, capacity);
+                    slots_ = old_slots;
+                    throw;
+                }
+                std::fill(ctrl_, ctrl_ + capacity + width, ctrl_empty);
+            }
+            capacity_    = capacity;
+            growth_left_ = capacity - capacity / 8 - size_;
+
+            // Keys are copied rather than moved: pair<const K, V> keeps them const
+            for (size_type i = 0; i < old_capacity; ++i) {
+                if (old_ctrl[i] >= 0) {
+                    const std::size_t hash = hash_of(KeyOf()(old_slots[i]));
+                    const size_type j = find_free(hash);
+                    slot_traits::construct(slot_alloc_, slots_ + j, std::move(old_slots[i]));
+                    slot_traits::destroy(slot_alloc_, old_slots + i);
+                    set_ctrl(j, h2(hash));
+                }
+            }
+            if (old_capacity) {
+                slot_traits::deallocate(slot_alloc_, old_slots, old_capacity);
+                ctrl_traits::deallocate(ctrl_alloc_, old_ctrl, old_capacity + width);
+            }
+        }
+
+        void destroy_elements() {
+            if constexpr (!std::is_trivially_destructible_v<Value>) {
+                for (size_type i = 0; i < capacity_; ++i)
+                    if (ctrl_[i] >= 0)
+                        slot_traits::destroy(slot_alloc_, slots_ + i);
+            }
+        }
+
+        void destroy() {
+            if (capacity_ == 0)
+                return;
+            destroy_elements();
+            slot_traits::deallocate(slot_alloc_, slots_, capacity_);
+            ctrl_traits::deallocate(ctrl_alloc_, ctrl_, capacity_ + width);
+        }
+
+        ctrl_t*   ctrl_        = empty_ctrl();
+        Value*    slots_       = nullptr;
+        size_type capacity_    = 0;
+        size_type size_        = 0;
+        size_type growth_left_ = 0; // free slots left before growing, counting tombstones as used
+        H         hash_;
+        E         equal_;
+        slot_allocator slot_alloc_;
+        ctrl_allocator ctrl_alloc_;
+    };
+} // namespace internal
+
+template<
+    class K,
+    class V,
+    class H = std::hash<K>,
+    class E = std::equal_to<K>,
+    class A = std::allocator<std::pair<const K, V>>
+>
+class flat_hash_map : public internal::flat_hash_table<std::pair<const K, V>, K, internal::key_of_pair, H, E, A>
+{
+    using table = internal::flat_hash_table<std::pair<const K, V>, K, internal::key_of_pair, H, E, A>;
+
+public:
+    using mapped_type = V;
+    using typename table::iterator;
+    using typename table::size_type;
+
+    using table::table; // inherit constructors, has to be explicit
+
+    flat_hash_map() = default;
+
+    // Inserts V constructed from args unless the key is already there
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return try_emplace_key(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second)
+            result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    V& operator[](K&& key)      { return try_emplace(std::move(key)).first->second; }
+
+    V& at(const K& key) {
+        const size_type i = table::find_index(key);
+        if (i == table::capacity())
+            throw std::out_of_range("FLAT_HASH_MAP KEY NOT FOUND");
+        return table::slot(i).second;
+    }
+
+    const V& at(const K& key) const { return const_cast<flat_hash_map*>(this)->at(key); }
+
+    friend bool operator==(const flat_hash_map& a, const flat_hash_map& b) {
+        if (a.size() != b.size())
+            return false;
+        for (const auto& [key, value] : a) {
+            const auto it = b.find(key);
+            if (it == b.end() || !(it->second == value))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const flat_hash_map& a, const flat_hash_map& b) { return !(a == b); }
+
+private:
+    template<class Key, class... Args>
+    std::pair<iterator, bool> try_emplace_key(Key&& key, Args&&... args) {
+        const std::size_t hash = table::hash_of(key);
+        const size_type found = table::find_index(key, hash);
+        if (found != table::capacity())
+            return { table::iterator_at(found), false };
+        const size_type i = table::insert_unique(hash, std::piecewise_construct,
+                                                 std::forward_as_tuple(std::forward<Key>(key)),
+                                                 std::forward_as_tuple(std::forward<Args>(args)...));
+        return { table::iterator_at(i), true };
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::flat_hash_set
+
+template<
+    class T,
+    class H = std::hash<T>,
+    class E = std::equal_to<T>,
+    class A = std::allocator<T>
+>
+class flat_hash_set : public internal::flat_hash_table<T, T, internal::key_of_value, H, E, A>
+{
+    using table = internal::flat_hash_table<T, T, internal::key_of_value, H, E, A>;
+
+public:
+    using table::table; // inherit constructors, has to be explicit
+
+    flat_hash_set() = default;
+
+    friend bool operator==(const flat_hash_set& a, const flat_hash_set& b) {
+        if (a.size() != b.size())
+            return false;
+        return std::all_of(a.begin(), a.end(), [&b](const T& x) { return b.contains(x); });
+    }
+
+    friend bool operator!=(const flat_hash_set& a, const flat_hash_set& b) { return !(a == b); }
+};
+
+} // namespace zen
@@ -0,0 +1,558 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::flat_map
+
+// Associative containers on sorted vectors, for data that is read far more often than written:
+// keys are contiguous (and values sit in an array of their own), so a lookup is a binary search
+// through a few cache lines instead of a walk through tree nodes. Inserting one element shifts
+// the rest, so build them with a bulk insert(first, last), which sorts and merges only once.
+// Like with vectors, inserting and erasing invalidates iterators.
+
+namespace internal {
+    // First of the n elements at base for which go_right() is false. The halving step compiles to
+    // a conditional move rather than a branch: no mispredictions, whatever the keys looked up.
+    template<class T, class GoRight>
+    const T* branchless_partition_point(const T* base, std::size_t n, GoRight go_right) {
+        if (n == 0)
+            return base;
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            base = go_right(base[half]) ? base + half : base;
+            n -= half;
+        }
+        return base + go_right(*base);
+    }
+
+    // std::vector<bool> packs its elements into bits and has no bool& to hand out,
+    // so the values of a flat map of bools are kept in one-member structs instead
+    struct flat_bool {
+        bool value = false;
+
+        flat_bool() = default;
+        flat_bool(bool v) : value(v) {}
+
+        friend bool operator==(const flat_bool& a, const flat_bool& b) { return a.value == b.value; }
+    };
+
+    // The sorted keys and their values behind zen::flat_map and zen::flat_multimap
+    template<class K, class V, class C, bool Multi>
+    class flat_tree {
+        ZEN_STATIC_ASSERT((!std::is_same_v<K, bool>), "FLAT MAP KEYS CAN'T BE bool (std::vector<bool> HAS NO data()); USE std::map OR A 2-ELEMENT ARRAY");
+
+    public:
+        using key_type        = K;
+        using mapped_type     = V;
+        using value_type      = std::pair<K, V>;
+        using key_compare     = C;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = std::pair<const K&, V&>;
+        using const_reference = std::pair<const K&, const V&>;
+
+    private:
+        using stored = std::conditional_t<std::is_same_v<V, bool>, flat_bool, V>;
+
+        static V& unwrap(stored& v) {
+            if constexpr (std::is_same_v<V, bool>) return v.value; else return v;
+        }
+
+        static const V& unwrap(const stored& v) {
+            if constexpr (std::is_same_v<V, bool>) return v.value; else return v;
+        }
+
+    public:
+        // Random access iterator whose elements are pairs of references into the two arrays
+        template<bool Const>
+        class basic_iterator {
+            using mapped = std::conditional_t<Const, const V, V>;
+            using slot   = std::conditional_t<Const, const stored, stored>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = std::pair<K, V>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::pair<const K&, mapped&>;
+
+            struct pointer { // what operator-> returns: the pair, kept alive for the expression
+                reference pair;
+                const reference* operator->() const { return &pair; }
+            };
+
+            basic_iterator() = default;
+            template<bool C2 = Const, class = std::enable_if_t<C2>>
+            basic_iterator(const basic_iterator<false>& it) : key_(it.key_), value_(it.value_) {}
+
+            reference operator*()  const { return { *key_, unwrap(*value_) }; }
+            pointer   operator->() const { return { **this }; }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            basic_iterator& operator++() { ++key_; ++value_; return *this; }
+            basic_iterator& operator--() { --key_; --value_; return *this; }
+            basic_iterator  operator++(int) { basic_iterator it = *this; ++*this; return it; }
+            basic_iterator  operator--(int) { basic_iterator it = *this; --*this; return it; }
+
+            basic_iterator& operator+=(difference_type n) { key_ += n; value_ += n; return *this; }
+            basic_iterator& operator-=(difference_type n) { key_ -= n; value_ -= n; return *this; }
+
+            friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+            friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+            friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) { return a.key_ - b.key_; }
+
+            friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.key_ == b.key_; }
+            friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return a.key_ != b.key_; }
+            friend bool operator< (const basic_iterator& a, const basic_iterator& b) { return a.key_ <  b.key_; }
+            friend bool operator> (const basic_iterator& a, const basic_iterator& b) { return a.key_ >  b.key_; }
+            friend bool operator<=(const basic_iterator& a, const basic_iterator& b) { return a.key_ <= b.key_; }
+            friend bool operator>=(const basic_iterator& a, const basic_iterator& b) { return a.key_ >= b.key_; }
+
+        private:
+            friend class flat_tree;
+            template<bool> friend class basic_iterator;
+
+            basic_iterator(const K* key, slot* value) : key_(key), value_(value) {}
+
+            const K* key_   = nullptr;
+            slot*    value_ = nullptr;
+        };
+
+        using iterator       = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        flat_tree() = default;
+
+        explicit flat_tree(const C& less) : less_(less) {}
+
+        template<class It>
+        flat_tree(It first, It last, const C& less = C()) : less_(less) { insert(first, last); }
+
+        flat_tree(std::initializer_list<value_type> init, const C& less = C()) : flat_tree(init.begin(), init.end(), less) {}
+
+        // From keys and the values that go with them, in any order
+        flat_tree(std::vector<K> keys, std::vector<V> values, const C& less = C()) : less_(less) {
+            if (keys.size() != values.size())
+                throw std::invalid_argument("FLAT MAP KEYS AND VALUES DIFFER IN SIZE");
+            std::vector<value_type> pairs;
+            pairs.reserve(keys.size());
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                pairs.emplace_back(std::move(keys[i]), std::move(values[i]));
+            merge(std::move(pairs));
+        }
+
+        flat_tree& operator=(std::initializer_list<value_type> init) {
+            clear();
+            insert(init);
+            return *this;
+        }
+
+        iterator       begin()        { return { keys_.data(), values_.data() }; }
+        const_iterator begin()  const { return { keys_.data(), values_.data() }; }
+        const_iterator cbegin() const { return begin(); }
+        iterator       end()          { return begin() + difference_type(size()); }
+        const_iterator end()    const { return begin() + difference_type(size()); }
+        const_iterator cend()   const { return end(); }
+
+        bool      empty()    const { return keys_.empty(); }
+        bool      is_empty() const { return keys_.empty(); }
+        size_type size()     const { return keys_.size(); }
+
+        // The sorted keys, and the values in the same order (a copy, for a map of bools)
+        const std::vector<K>& keys() const { return keys_; }
+
+        decltype(auto) values() const {
+            if constexpr (std::is_same_v<V, bool>) {
+                std::vector<bool> values;
+                values.reserve(values_.size());
+                for (const auto& v : values_)
+                    values.push_back(v.value);
+                return values;
+            } else {
+                return (values_); // a reference
+            }
+        }
+
+        key_compare key_comp() const { return less_; }
+
+        void reserve(size_type n) {
+            keys_.reserve(n);
+            values_.reserve(n);
+        }
+
+        void shrink_to_fit() {
+            keys_.shrink_to_fit();
+            values_.shrink_to_fit();
+        }
+
+        void clear() {
+            keys_.clear();
+            values_.clear();
+        }
+
+        // One element: shifts the elements after it, like vector::insert does
+        std::pair<iterator, bool> insert(const value_type& v) { return emplace_at(v.first, v.second); }
+        std::pair<iterator, bool> insert(value_type&& v)      { return emplace_at(std::move(v.first), std::move(v.second)); }
+
+        template<class P, class = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+        std::pair<iterator, bool> insert(P&& p) { return insert(value_type(std::forward<P>(p))); }
+
+        // Many elements: sorts them on their own, then merges them with the present ones in one pass
+        template<class It>
+        void insert(It first, It last) { merge(std::vector<value_type>(first, last)); }
+
+        void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) { return insert(value_type(std::forward<Args>(args)...)); }
+
+        iterator       lower_bound(const K& key)       { return at_index(lower_index(key)); }
+        const_iterator lower_bound(const K& key) const { return const_cast<flat_tree*>(this)->lower_bound(key); }
+        iterator       upper_bound(const K& key)       { return at_index(upper_index(key)); }
+        const_iterator upper_bound(const K& key) const { return const_cast<flat_tree*>(this)->upper_bound(key); }
+
+        std::pair<iterator, iterator> equal_range(const K& key) {
+            const size_type i = lower_index(key);
+            if constexpr (Multi)
+                return { at_index(i), at_index(upper_index(key)) };
+            else
+                return { at_index(i), at_index(i + (i != size() && !less_(key, keys_[i]))) };
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+            return const_cast<flat_tree*>(this)->equal_range(key);
+        }
+
+        iterator       find(const K& key)       { return at_index(find_index(key)); }
+        const_iterator find(const K& key) const { return const_cast<flat_tree*>(this)->find(key); }
+
+        bool contains(const K& key) const { return find_index(key) != size(); }
+
+        size_type count(const K& key) const {
+            const auto [first, last] = equal_range(key);
+            return static_cast<size_type>(last - first);
+        }
+
+        size_type erase(const K& key) {
+            const auto [first, last] = equal_range(key);
+            const size_type n = static_cast<size_type>(last - first);
+            erase(first, last);
+            return n;
+        }
+
+        iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const difference_type i = first - cbegin(), j = last - cbegin();
+            keys_.erase(  keys_.begin()   + i, keys_.begin()   + j);
+            values_.erase(values_.begin() + i, values_.begin() + j);
+            return begin() + i;
+        }
+
+        void swap(flat_tree& other) noexcept {
+            using std::swap;
+            swap(keys_, other.keys_);
+            swap(values_, other.values_);
+            swap(less_, other.less_);
+        }
+
+        friend bool operator==(const flat_tree& a, const flat_tree& b) { return a.keys_ == b.keys_ && a.values_ == b.values_; }
+        friend bool operator!=(const flat_tree& a, const flat_tree& b) { return !(a == b); }
+
+    protected:
+        size_type lower_index(const K& key) const {
+            const K* keys = keys_.data();
+            return static_cast<size_type>(branchless_partition_point(keys, keys_.size(), [&](const K& k) { return less_(k, key); }) - keys);
+        }
+
+        size_type upper_index(const K& key) const {
+            const K* keys = keys_.data();
+            return static_cast<size_type>(branchless_partition_point(keys, keys_.size(), [&](const K& k) { return !less_(key, k); }) - keys);
+        }
+
+        // Index of the (first) element with key, or size()
+        size_type find_index(const K& key) const {
+            const size_type i = lower_index(key);
+            return i != size() && !less_(key, keys_[i]) ? i : size();
+        }
+
+        iterator at_index(size_type i) { return begin() + difference_type(i); }
+
+        V& value_at(size_type i) { return unwrap(values_[i]); }
+
+        template<class Key, class... Args>
+        std::pair<iterator, bool> emplace_at(Key&& key, Args&&... args) {
+            const size_type i = Multi ? upper_index(key) : lower_index(key);
+            if (!Multi && i != size() && !less_(key, keys_[i]))
+                return { at_index(i), false };
+            keys_.insert(keys_.begin() + difference_type(i), std::forward<Key>(key));
+            try {
+                values_.insert(values_.begin() + difference_type(i), stored(V(std::forward<Args>(args)...)));
+            } catch (...) {
+                keys_.erase(keys_.begin() + difference_type(i));
+                throw;
+            }
+            return { at_index(i), true };
+        }
+
+    private:
+        // Sorts fresh and merges it in. For equal keys, present elements come first, and a map
+        // keeps only the first element: the same choices as insertion one by one.
+        void merge(std::vector<value_type>&& fresh) {
+            if (fresh.empty())
+                return;
+            const auto by_key = [this](const value_type& a, const value_type& b) { return less_(a.first, b.first); };
+            std::stable_sort(fresh.begin(), fresh.end(), by_key);
+            if constexpr (!Multi) {
+                fresh.erase(std::unique(fresh.begin(), fresh.end(), [this](const value_type& a, const value_type& b) {
+                    return !less_(a.first, b.first);
+                }), fresh.end());
+            }
+
+            std::vector<K>      keys;
+            std::vector<stored> values;
+            keys.reserve(size() + fresh.size());
+            values.reserve(size() + fresh.size());
+
+            size_type i = 0;
+            for (value_type& v : fresh) {
+                for (; i < size() && !less_(v.first, keys_[i]); ++i) {
+                    keys.push_back(std::move(keys_[i]));
+                    values.push_back(std::move(values_[i]));
+                }
+                if (!Multi && !keys.empty() && !less_(keys.back(), v.first))
+                    continue; // the key is there already
+                keys.push_back(std::move(v.first));
+                values.push_back(std::move(v.second));
+            }
+            for (; i < size(); ++i) {
+                keys.push_back(std::move(keys_[i]));
+                values.push_back(std::move(values_[i]));
+            }
+            keys_   = std::move(keys);
+            values_ = std::move(values);
+        }
+
+        std::vector<K>      keys_;
+        std::vector<stored> values_;
+        C                   less_;
+    };
+} // namespace internal
+
+template<class K, class V, class C = std::less<K>>
+class flat_map : public internal::flat_tree<K, V, C, false>
+{
+    using tree = internal::flat_tree<K, V, C, false>;
+
+public:
+    using typename tree::iterator;
+    using typename tree::size_type;
+
+    using tree::tree; // inherit constructors, has to be explicit
+
+    flat_map() = default;
+
+    // Inserts V constructed from args unless the key is already there
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) { return tree::emplace_at(key, std::forward<Args>(args)...); }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) { return tree::emplace_at(std::move(key), std::forward<Args>(args)...); }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second)
+            result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    V& operator[](const K& key) { return (*try_emplace(key).first).second; }
+    V& operator[](K&& key)      { return (*try_emplace(std::move(key)).first).second; }
+
+    V& at(const K& key) {
+        const size_type i = tree::find_index(key);
+        if (i == tree::size())
+            throw std::out_of_range("FLAT_MAP KEY NOT FOUND");
+        return tree::value_at(i);
+    }
+
+    const V& at(const K& key) const { return const_cast<flat_map*>(this)->at(key); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::flat_multimap
+
+template<class K, class V, class C = std::less<K>>
+class flat_multimap : public internal::flat_tree<K, V, C, true>
+{
+    using tree = internal::flat_tree<K, V, C, true>;
+
+public:
+    using tree::tree; // inherit constructors, has to be explicit
+
+    flat_multimap() = default;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::flat_set
+
+template<class T, class C = std::less<T>>
+class flat_set
+{
+    ZEN_STATIC_ASSERT((!std::is_same_v<T, bool>), "FLAT SET ELEMENTS CAN'T BE bool (std::vector<bool> HAS NO data()); USE std::set OR A 2-ELEMENT ARRAY");
+
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using key_compare     = C;
+    using value_compare   = C;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = const T&;
+    using const_reference = const T&;
+    using iterator        = typename std::vector<T>::const_iterator; // elements are keys: not modifiable
+    using const_iterator  = iterator;
+
+    flat_set() = default;
+
+    explicit flat_set(const C& less) : less_(less) {}
+
+    template<class It>
+    flat_set(It first, It last, const C& less = C()) : less_(less) { insert(first, last); }
+
+    flat_set(std::initializer_list<T> init, const C& less = C()) : flat_set(init.begin(), init.end(), less) {}
+
+    flat_set& operator=(std::initializer_list<T> init) {
+        clear();
+        insert(init);
+        return *this;
+    }
+
+    iterator begin()  const { return items_.begin(); }
+    iterator cbegin() const { return items_.begin(); }
+    iterator end()    const { return items_.end(); }
+    iterator cend()   const { return items_.end(); }
+
+    bool      empty()    const { return items_.empty(); }
+    bool      is_empty() const { return items_.empty(); }
+    size_type size()     const { return items_.size(); }
+
+    // The sorted elements
+    const std::vector<T>& items() const { return items_; }
+
+    key_compare key_comp() const { return less_; }
+
+    void reserve(size_type n) { items_.reserve(n); }
+    void shrink_to_fit()      { items_.shrink_to_fit(); }
+    void clear()              { items_.clear(); }
+
+    std::pair<iterator, bool> insert(const T& x) { return emplace_at(x); }
+    std::pair<iterator, bool> insert(T&& x)      { return emplace_at(std::move(x)); }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) { return emplace_at(T(std::forward<Args>(args)...)); }
+
+    // Many elements: appends and sorts them, then merges them with the present ones in one pass
+    template<class It>
+    void insert(It first, It last) {
+        const auto middle = static_cast<difference_type>(items_.size());
+        items_.insert(items_.end(), first, last);
+        std::stable_sort(items_.begin() + middle, items_.end(), less_);
+        std::inplace_merge(items_.begin(), items_.begin() + middle, items_.end(), less_);
+        items_.erase(std::unique(items_.begin(), items_.end(), [this](const T& a, const T& b) { return !less_(a, b); }), items_.end());
+    }
+
+    void insert(std::initializer_list<T> init) { insert(init.begin(), init.end()); }
+
+    iterator lower_bound(const T& x) const { return begin() + difference_type(lower_index(x)); }
+
+    iterator upper_bound(const T& x) const {
+        const T* items = items_.data();
+        return begin() + (internal::branchless_partition_point(items, items_.size(), [&](const T& y) { return !less_(x, y); }) - items);
+    }
+
+    std::pair<iterator, iterator> equal_range(const T& x) const {
+        const iterator it = lower_bound(x);
+        return { it, it + (it != end() && !less_(x, *it)) };
+    }
+
+    iterator find(const T& x) const {
+        const iterator it = lower_bound(x);
+        return it != end() && !less_(x, *it) ? it : end();
+    }
+
+    bool      contains(const T& x) const { return find(x) != end(); }
+    size_type count(const T& x)    const { return contains(x) ? 1 : 0; }
+
+    size_type erase(const T& x) {
+        const iterator it = find(x);
+        if (it == end())
+            return 0;
+        items_.erase(it);
+        return 1;
+    }
+
+    iterator erase(iterator pos)                 { return items_.erase(pos); }
+    iterator erase(iterator first, iterator last) { return items_.erase(first, last); }
+
+    void swap(flat_set& other) noexcept {
+        using std::swap;
+        swap(items_, other.items_);
+        swap(less_, other.less_);
+    }
+
+    friend bool operator==(const flat_set& a, const flat_set& b) { return a.items_ == b.items_; }
+    friend bool operator!=(const flat_set& a, const flat_set& b) { return !(a == b); }
+
+private:
+    size_type lower_index(const T& x) const {
+        const T* items = items_.data();
+        return static_cast<size_type>(internal::branchless_partition_point(items, items_.size(), [&](const T& y) { return less_(y, x); }) - items);
+    }
+
+    template<class X>
+    std::pair<iterator, bool> emplace_at(X&& x) {
+        const size_type i = lower_index(x);
+        if (i != size() && !less_(x, items_[i]))
+            return { begin() + difference_type(i), false };
+        return { items_.insert(begin() + difference_type(i), std::forward<X>(x)), true };
+    }
+
+    std::vector<T> items_;
+    C              less_;
+};
+
+} // namespace zen
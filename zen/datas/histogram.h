@@ -0,0 +1,278 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <bit>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::histogram
+
+// A latency histogram in the spirit of HdrHistogram: values are counted in log-linear buckets
+// (exponentially growing buckets, each split into linear sub-buckets) so that any recorded value
+// is reproduced with a fixed number of significant decimal digits. Recording is O(1), memory is
+// fixed at construction, and percentiles come straight from the counts, without storing samples.
+// Example: zen::histogram h; // 1 ns up to 1 hour with 3 significant digits
+//          h.record(timer.duration<zen::timer::nsec>()); // or: timer.record_into(h);
+//          h.value_at_percentile(99.9);
+// Result:  The p99.9 latency in nanoseconds, within 0.1% of the true value
+class histogram {
+public:
+    explicit histogram(std::uint64_t highest_trackable = 3'600'000'000'000, int significant_digits = 3)
+        : highest_(highest_trackable), digits_(significant_digits)
+    {
+        if (highest_trackable < 2 || significant_digits < 1 || significant_digits > 5)
+            throw std::invalid_argument("zen::histogram EXPECTS highest_trackable >= 2 AND significant_digits IN [1, 5]");
+
+        const auto single_unit_resolution = 2 * static_cast<std::uint64_t>(std::pow(10, significant_digits));
+        sub_bucket_count_magnitude_ = 0;
+        while ((std::uint64_t(1) << sub_bucket_count_magnitude_) < single_unit_resolution)
+            ++sub_bucket_count_magnitude_;
+        sub_bucket_half_count_magnitude_ = sub_bucket_count_magnitude_ - 1;
+        sub_bucket_count_                = std::uint64_t(1) << sub_bucket_count_magnitude_;
+        sub_bucket_half_count_           = sub_bucket_count_ / 2;
+        sub_bucket_mask_                 = sub_bucket_count_ - 1;
+
+        // Enough buckets for the smallest untrackable value to exceed the highest trackable one
+        std::uint64_t smallest_untrackable = sub_bucket_count_;
+        int buckets = 1;
+        while (smallest_untrackable <= highest_) {
+            if (smallest_untrackable > (UINT64_MAX >> 1)) { ++buckets; break; }
+            smallest_untrackable <<= 1;
+            ++buckets;
+        }
+        counts_.assign(static_cast<std::size_t>(buckets + 1) * sub_bucket_half_count_, 0);
+    }
+
+    // Values above the highest trackable one are recorded as the highest trackable one
+    void record(std::uint64_t value, std::uint64_t n = 1) {
+        value = std::min(value, highest_);
+        counts_[index_of(value)] += n;
+        total_ += n;
+        min_    = std::min(min_, value);
+        max_    = std::max(max_, value);
+    }
+
+    // Durations are recorded in nanoseconds; negative ones as 0
+    template<class Rep, class Period>
+    void record(const std::chrono::duration<Rep, Period>& d) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+    }
+
+    // Adds all counts of another histogram, e.g. one filled by another thread
+    void merge(const histogram& other) {
+        if (other.highest_ != highest_ || other.digits_ != digits_)
+            throw std::invalid_argument("zen::histogram CAN ONLY MERGE HISTOGRAMS OF THE SAME CONFIGURATION");
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+            counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        min_    = std::min(min_, other.min_);
+        max_    = std::max(max_, other.max_);
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        min_   = UINT64_MAX;
+        max_   = 0;
+    }
+
+    // Example: h.value_at_percentile(50); // median
+    std::uint64_t value_at_percentile(double p) const {
+        if (!total_) return 0;
+        const double clamped = std::clamp(p, 0.0, 100.0);
+        const auto   target  = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total_))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target)
+                return std::min(max_, highest_equivalent(value_at_index(i)));
+        }
+        return max_;
+    }
+
+    double mean() const {
+        if (!total_) return 0.0;
+        double sum = 0.0;
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+            if (counts_[i])
+                sum += static_cast<double>(counts_[i]) * static_cast<double>(median_equivalent(value_at_index(i)));
+        return sum / static_cast<double>(total_);
+    }
+
+    std::uint64_t count() const { return total_; }
+    std::uint64_t min()   const { return total_ ? min_ : 0; }
+    std::uint64_t max()   const { return max_; }
+
+    std::uint64_t highest_trackable()  const { return highest_; }
+    int           significant_digits() const { return digits_; }
+
+    bool is_empty() const { return total_ == 0; }
+
+    // Number of recorded values that fall in the same bucket as the given value
+    std::uint64_t count_at(std::uint64_t value) const { return counts_[index_of(std::min(value, highest_))]; }
+
+    // Compact binary form: the configuration followed by the counts as LEB128 varints,
+    // where runs of empty buckets collapse into a single zigzag-encoded negative number.
+    // Example: auto h2 = zen::histogram::deserialize(h1.serialize());
+    std::string serialize() const {
+        std::string out = "ZH1";
+        put_varint(out, highest_);
+        put_varint(out, static_cast<std::uint64_t>(digits_));
+        put_varint(out, min_);
+        put_varint(out, max_);
+        for (std::size_t i = 0; i < counts_.size();) {
+            if (counts_[i]) {
+                put_varint(out, zigzag(static_cast<std::int64_t>(counts_[i++])));
+                continue;
+            }
+            std::int64_t zeros = 0;
+            while (i < counts_.size() && !counts_[i]) { ++zeros; ++i; }
+            put_varint(out, zigzag(-zeros));
+        }
+        return out;
+    }
+
+    static histogram deserialize(std::string_view in) {
+        if (in.substr(0, 3) != "ZH1")
+            throw std::invalid_argument("zen::histogram::deserialize() INPUT IS NOT A SERIALIZED zen::histogram");
+        in.remove_prefix(3);
+
+        const auto highest = get_varint(in);
+        const auto digits  = get_varint(in);
+        histogram h(highest, static_cast<int>(digits));
+        h.min_ = get_varint(in);
+        h.max_ = get_varint(in);
+
+        std::size_t i = 0;
+        while (!in.empty()) {
+            const auto v = unzigzag(get_varint(in));
+            if (v < 0) {
+                i += static_cast<std::size_t>(-v);
+                continue;
+            }
+            if (i >= h.counts_.size())
+                throw std::invalid_argument("zen::histogram::deserialize() INPUT HAS MORE COUNTS THAN BUCKETS");
+            h.counts_[i++] = static_cast<std::uint64_t>(v);
+            h.total_      += static_cast<std::uint64_t>(v);
+        }
+        return h;
+    }
+
+private:
+    static int bit_width(std::uint64_t x) {
+#if __cpp_lib_int_pow2 >= 202002L
+        return static_cast<int>(std::bit_width(x));
+#elif defined(__GNUC__) || defined(__clang__)
+        return x ? 64 - __builtin_clzll(x) : 0;
+#else
+        int w = 0;
+        while (x) { x >>= 1; ++w; }
+        return w;
+#endif
+    }
+
+    int bucket_index(std::uint64_t value) const {
+        return bit_width(value | sub_bucket_mask_) - (sub_bucket_half_count_magnitude_ + 1);
+    }
+
+    std::size_t index_of(std::uint64_t value) const {
+        const int  bucket     = bucket_index(value);
+        const auto sub_bucket = value >> bucket;
+        return (static_cast<std::size_t>(bucket + 1) << sub_bucket_half_count_magnitude_) + (sub_bucket - sub_bucket_half_count_);
+    }
+
+    std::uint64_t value_at_index(std::size_t index) const {
+        int  bucket     = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+        auto sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+        if (bucket < 0) {
+            sub_bucket -= sub_bucket_half_count_;
+            bucket      = 0;
+        }
+        return static_cast<std::uint64_t>(sub_bucket) << bucket;
+    }
+
+    std::uint64_t equivalent_range(std::uint64_t value) const {
+        const int  bucket     = bucket_index(value);
+        const auto sub_bucket = value >> bucket;
+        return std::uint64_t(1) << (bucket + (sub_bucket >= sub_bucket_count_ ? 1 : 0));
+    }
+
+    std::uint64_t lowest_equivalent(std::uint64_t value) const {
+        const int bucket = bucket_index(value);
+        return (value >> bucket) << bucket;
+    }
+
+    std::uint64_t highest_equivalent(std::uint64_t value) const { return lowest_equivalent(value) + equivalent_range(value) - 1; }
+    std::uint64_t  median_equivalent(std::uint64_t value) const { return lowest_equivalent(value) + equivalent_range(value) / 2; }
+
+    static std::uint64_t zigzag(std::int64_t v)    { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+    static std::int64_t unzigzag(std::uint64_t v)  { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+    static void put_varint(std::string& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out += static_cast<char>((v & 0x7F) | 0x80);
+            v  >>= 7;
+        }
+        out += static_cast<char>(v);
+    }
+
+    static std::uint64_t get_varint(std::string_view& in) {
+        std::uint64_t v = 0;
+        for (int shift = 0; !in.empty() && shift < 64; shift += 7) {
+            const auto byte = static_cast<unsigned char>(in.front());
+            in.remove_prefix(1);
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return v;
+        }
+        throw std::invalid_argument("zen::histogram::deserialize() INPUT IS TRUNCATED");
+    }
+
+private:
+    std::uint64_t highest_;
+    int           digits_;
+    int           sub_bucket_count_magnitude_      = 0;
+    int           sub_bucket_half_count_magnitude_ = 0;
+    std::uint64_t sub_bucket_count_                = 0;
+    std::uint64_t sub_bucket_half_count_           = 0;
+    std::uint64_t sub_bucket_mask_                 = 0;
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_ = 0;
+    std::uint64_t min_   = UINT64_MAX;
+    std::uint64_t max_   = 0;
+};
+
+} // namespace zen
@@ -0,0 +1,230 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <type_traits>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "alpha.h"         // internal; will not be included in kaizen.h
+#include "flat_hash_map.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::indexed_priority_queue
+
+// A priority queue of keys, each in it at most once, whose priorities can change in place:
+// Dijkstra-style algorithms update a key instead of pushing a duplicate and skipping it later,
+// so the queue never holds more than the live keys. A D-ary heap (4-ary by default) holds the
+// priorities along with slot numbers; a position array keeps track of where each slot sits in
+// the heap, and a hash map finds the slot of a key. As with zen::priority_queue, the top is the
+// greatest priority: use std::greater for a min-queue.
+// Example: zen::indexed_priority_queue<int, double, std::greater<double>> q; // nearest first
+//          q.push(1, 5.0);
+//          q.push(2, 7.0);
+//          q.decrease_key(2, 3.0);
+// Result: q.top_key() == 2
+
+template<
+    class Key,
+    class Priority,
+    class L = std::less<Priority>,
+    std::size_t D = 4,
+    class H = std::hash<Key>,
+    class E = std::equal_to<Key>
+>
+class indexed_priority_queue
+{
+    ZEN_STATIC_ASSERT(D >= 2, "A HEAP NEEDS AT LEAST 2 CHILDREN PER NODE");
+
+    struct entry {
+        Priority    priority;
+        std::size_t slot;
+    };
+
+public:
+    using key_type      = Key;
+    using priority_type = Priority;
+    using size_type     = std::size_t;
+
+    static constexpr std::size_t arity = D;
+
+    indexed_priority_queue() = default;
+
+    explicit indexed_priority_queue(const L& comp) : comp_(comp) {}
+
+    bool      empty()    const { return heap_.empty(); }
+    bool      is_empty() const { return heap_.empty(); }
+    size_type size()     const { return heap_.size(); }
+
+    void reserve(size_type n) {
+        heap_.reserve(n);
+        keys_.reserve(n);
+        positions_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    void clear() {
+        heap_.clear();
+        keys_.clear();
+        positions_.clear();
+        free_.clear();
+        slots_.clear();
+    }
+
+    bool contains(const Key& key) const { return slots_.contains(key); }
+
+    const Priority& priority(const Key& key) const { return heap_[positions_[slot_of(key)]].priority; }
+
+    const Key&      top_key()      const { return keys_[heap_.front().slot]; }
+    const Priority& top_priority() const { return heap_.front().priority; }
+
+    std::pair<const Key&, const Priority&> top() const { return { top_key(), top_priority() }; }
+
+    // Adds a key that isn't in the queue yet; returns false (and changes nothing) if it is
+    bool push(const Key& key, Priority priority) {
+        const auto [it, inserted] = slots_.try_emplace(key, keys_.size());
+        if (!inserted)
+            return false;
+        std::size_t slot = it->second;
+        if (!free_.empty()) { // reuse the slot of a popped key
+            slot = it->second = free_.back();
+            free_.pop_back();
+            keys_[slot] = key;
+        } else {
+            keys_.push_back(key);
+            positions_.push_back(0);
+        }
+        heap_.push_back({ std::move(priority), slot });
+        sift_up(heap_.size() - 1);
+        return true;
+    }
+
+    // Sets the priority of a key, adding the key if it isn't in the queue
+    void update(const Key& key, Priority priority) {
+        const auto it = slots_.find(key);
+        if (it == slots_.end()) {
+            push(key, std::move(priority));
+            return;
+        }
+        const std::size_t i = positions_[it->second];
+        const bool up = comp_(heap_[i].priority, priority);
+        heap_[i].priority = std::move(priority);
+        if (up)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    // Changes the priority of a key in the queue, in O(log n). Both move it whichever way the
+    // new priority takes it; the names are those that graph algorithms use.
+    void decrease_key(const Key& key, Priority priority) { change(key, std::move(priority)); }
+    void increase_key(const Key& key, Priority priority) { change(key, std::move(priority)); }
+
+    void pop() { erase_at(0); }
+
+    // Removes a key, wherever it is in the heap; returns false if it's not in the queue
+    bool erase(const Key& key) {
+        const auto it = slots_.find(key);
+        if (it == slots_.end())
+            return false;
+        erase_at(positions_[it->second]);
+        return true;
+    }
+
+private:
+    std::size_t slot_of(const Key& key) const {
+        const auto it = slots_.find(key);
+        if (it == slots_.end())
+            throw std::out_of_range("KEY NOT IN INDEXED PRIORITY QUEUE");
+        return it->second;
+    }
+
+    void change(const Key& key, Priority priority) {
+        slot_of(key); // throws for unknown keys, rather than adding them like update() does
+        update(key, std::move(priority));
+    }
+
+    void erase_at(std::size_t i) {
+        const std::size_t slot = heap_[i].slot;
+        slots_.erase(keys_[slot]);
+        free_.push_back(slot);
+
+        entry last = std::move(heap_.back());
+        heap_.pop_back();
+        if (i == heap_.size())
+            return;
+        const bool up = comp_(heap_[i].priority, last.priority);
+        place(i, std::move(last));
+        if (up)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    void place(std::size_t i, entry&& e) {
+        positions_[e.slot] = i;
+        heap_[i] = std::move(e);
+    }
+
+    void sift_up(std::size_t i) {
+        entry e = std::move(heap_[i]);
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / D;
+            if (!comp_(heap_[parent].priority, e.priority))
+                break;
+            place(i, std::move(heap_[parent]));
+            i = parent;
+        }
+        place(i, std::move(e));
+    }
+
+    void sift_down(std::size_t i) {
+        const std::size_t n = heap_.size();
+        entry e = std::move(heap_[i]);
+        for (std::size_t child = D * i + 1; child < n; child = D * i + 1) {
+            const std::size_t last = std::min(child + D, n);
+            std::size_t top = child;
+            for (std::size_t j = child + 1; j < last; ++j)
+                top = comp_(heap_[top].priority, heap_[j].priority) ? j : top;
+            if (!comp_(e.priority, heap_[top].priority))
+                break;
+            place(i, std::move(heap_[top]));
+            i = top;
+        }
+        place(i, std::move(e));
+    }
+
+    std::vector<entry>       heap_;
+    std::vector<Key>         keys_;      // by slot
+    std::vector<std::size_t> positions_; // by slot: where in heap_ the slot is
+    std::vector<std::size_t> free_;      // slots of popped keys, to reuse
+    zen::flat_hash_map<Key, std::size_t, H, E> slots_;
+    L                        comp_;
+};
+
+} // namespace zen
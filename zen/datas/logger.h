@@ -0,0 +1,547 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <string_view>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::logger
+
+// Asynchronous backend for zen::log(). Once zen::logger::start() is called, every thread that
+// logs gets its own lock-free single-producer/single-consumer ring of records. zen::log() formats
+// the line on the calling thread, copies it into that ring and returns; a single writer thread
+// drains all rings into one large buffer and hands it to the sinks according to the flush policy.
+// Lines are never interleaved mid-line, and lines from the same thread keep their order.
+// Example: zen::logger::start();                                                   // to stdout
+//          zen::logger::start({ std::make_shared<zen::file_sink>("app.log") });    // to a file
+//          zen::log("Hello", 42);                                                  // as always
+//          zen::logger::stop();                                                    // drains & joins
+
+enum class flush_policy {
+    every_record, // write & flush the sinks as soon as records arrive
+    interval,     // write & flush at most every flush_interval (or when the buffer is full)
+    manual        // write when the buffer is full, flush only on logger::flush() and stop()
+};
+
+enum class overflow_policy {
+    block, // a full ring makes the logging thread wait for the writer
+    drop   // a full ring makes the record get dropped (and counted in logger::dropped())
+};
+
+struct log_options {
+    zen::flush_policy         flush          = flush_policy::interval;
+    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(100);
+    std::size_t               buffer_size    = std::size_t(1) << 20; // writer-side bytes before a write
+    std::size_t               queue_size     = std::size_t(1) << 20; // per-thread ring bytes (rounded up to 2^N)
+    zen::overflow_policy      overflow       = overflow_policy::block;
+};
+
+// Where the writer thread puts the text. Sinks are only ever called from the writer thread.
+class log_sink {
+public:
+    virtual ~log_sink() = default;
+    virtual void write(std::string_view text) = 0;
+    virtual void flush() {}
+};
+
+class stdout_sink : public log_sink {
+public:
+    void write(std::string_view text) override { std::cout.write(text.data(), static_cast<std::streamsize>(text.size())); }
+    void flush()                      override { std::cout.flush(); }
+};
+
+class file_sink : public log_sink {
+public:
+    explicit file_sink(const std::filesystem::path& path, bool append = true)
+        : file_(path, append ? std::ios::binary | std::ios::app : std::ios::binary | std::ios::trunc)
+    {
+        if (!file_.is_open())
+            throw std::runtime_error("ERROR OPENING LOG FILE: " + zen::quote(path.string()));
+    }
+
+    void write(std::string_view text) override { file_.write(text.data(), static_cast<std::streamsize>(text.size())); }
+    void flush()                      override { file_.flush(); }
+
+private:
+    std::ofstream file_;
+};
+
+// Keeps at most max_files files of roughly max_bytes each: app.log, app.log.1, app.log.2, ...
+// When app.log is full, each file moves one number up and the oldest one is deleted.
+class rotating_file_sink : public log_sink {
+public:
+    rotating_file_sink(const std::filesystem::path& path, std::size_t max_bytes, std::size_t max_files = 5)
+        : path_(path), max_bytes_(std::max<std::size_t>(max_bytes, 1)), max_files_(std::max<std::size_t>(max_files, 1))
+    {
+        open();
+    }
+
+    void write(std::string_view text) override {
+        while (!text.empty()) {
+            if (written_ >= max_bytes_)
+                rotate();
+
+            // Split at line ends so that no line straddles two files
+            std::size_t n = std::min(text.size(), max_bytes_ - written_);
+            if (n < text.size()) {
+                const auto eol = text.rfind('\n', n - 1);
+                n = (eol != std::string_view::npos) ? eol + 1 : (written_ ? 0 : n);
+            }
+            if (n == 0) {
+                rotate();
+                continue;
+            }
+            file_.write(text.data(), static_cast<std::streamsize>(n));
+            written_ += n;
+            text.remove_prefix(n);
+        }
+    }
+
+    void flush() override { file_.flush(); }
+
+private:
+    std::filesystem::path numbered(std::size_t i) const {
+        return i ? std::filesystem::path(path_.string() + "." + std::to_string(i)) : path_;
+    }
+
+    void open() {
+        file_.open(path_, std::ios::binary | std::ios::app);
+        if (!file_.is_open())
+            throw std::runtime_error("ERROR OPENING LOG FILE: " + zen::quote(path_.string()));
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path_, ec);
+        written_ = ec ? 0 : static_cast<std::size_t>(size);
+    }
+
+    void rotate() {
+        file_.close();
+        std::error_code ec; // rotation is best effort: a missing file is not a problem
+        std::filesystem::remove(numbered(max_files_ - 1), ec);
+        for (std::size_t i = max_files_ - 1; i > 0; --i)
+            std::filesystem::rename(numbered(i - 1), numbered(i), ec);
+        open();
+    }
+
+    std::filesystem::path path_;
+    std::size_t           max_bytes_;
+    std::size_t           max_files_;
+    std::size_t           written_ = 0;
+    std::ofstream         file_;
+};
+
+namespace internal {
+    enum class log_record : std::uint32_t { padding, text, oversized, deferred };
+
+    // Single-producer/single-consumer ring of variable-length records, each an 8-byte header
+    // (payload size and kind) followed by the payload, padded to 8 bytes. A record never wraps:
+    // if it doesn't fit before the end of the buffer, a padding record fills the rest.
+    class log_ring {
+    public:
+        explicit log_ring(std::size_t capacity) {
+            std::size_t n = 64;
+            while (n < capacity) n <<= 1;
+            capacity_ = n;
+            buffer_   = std::make_unique<std::uint64_t[]>(n / sizeof(std::uint64_t));
+        }
+
+        std::size_t capacity() const { return capacity_; }
+
+        // Whether a payload of n bytes can ever fit
+        bool fits(std::size_t n) const { return record_size(n) <= capacity_; }
+
+        // Producer: room for a payload of n bytes, or nullptr if the ring is too full right now
+        char* reserve(std::size_t n, log_record kind) {
+            const std::size_t total = record_size(n);
+            if (total > capacity_)
+                return nullptr;
+
+            std::uint64_t pos    = head_.load(std::memory_order_relaxed);
+            const auto    offset = static_cast<std::size_t>(pos & (capacity_ - 1));
+            const auto    pad    = (offset + total > capacity_) ? capacity_ - offset : 0;
+
+            if (pos + pad + total - cached_tail_ > capacity_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (pos + pad + total - cached_tail_ > capacity_)
+                    return nullptr;
+            }
+            if (pad) {
+                write_header(offset, static_cast<std::uint32_t>(pad - header_size), log_record::padding);
+                pos += pad;
+            }
+            const auto at = static_cast<std::size_t>(pos & (capacity_ - 1));
+            write_header(at, static_cast<std::uint32_t>(n), kind);
+            pending_ = pos + total;
+            return bytes() + at + header_size;
+        }
+
+        // Producer: publishes the record returned by the last reserve()
+        void commit() { head_.store(pending_, std::memory_order_release); }
+
+        // Consumer: calls f(kind, payload) for every published record, then frees their space
+        template<class F>
+        std::size_t drain(F&& f) {
+            std::uint64_t       tail  = tail_.load(std::memory_order_relaxed);
+            const std::uint64_t head  = head_.load(std::memory_order_acquire);
+            std::size_t         count = 0;
+            while (tail < head) {
+                const auto   at = static_cast<std::size_t>(tail & (capacity_ - 1));
+                std::uint32_t size, kind;
+                std::memcpy(&size, bytes() + at,     sizeof(size));
+                std::memcpy(&kind, bytes() + at + 4, sizeof(kind));
+                if (static_cast<log_record>(kind) != log_record::padding) {
+                    f(static_cast<log_record>(kind), std::string_view(bytes() + at + header_size, size));
+                    ++count;
+                }
+                tail += record_size(size);
+            }
+            tail_.store(tail, std::memory_order_release);
+            return count;
+        }
+
+        bool is_empty() const { return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire); }
+
+        std::atomic<bool>       closed{false}; // set when the producing thread exits
+        std::mutex              oversized_mutex;
+        std::deque<std::string> oversized;     // records too large for the ring, in order
+
+    private:
+        static constexpr std::size_t header_size = 8;
+        static std::size_t record_size(std::size_t n) { return (header_size + n + 7) & ~std::size_t(7); }
+
+        char* bytes() const { return reinterpret_cast<char*>(buffer_.get()); }
+
+        void write_header(std::size_t at, std::uint32_t size, log_record kind) {
+            const auto k = static_cast<std::uint32_t>(kind);
+            std::memcpy(bytes() + at,     &size, sizeof(size));
+            std::memcpy(bytes() + at + 4, &k,    sizeof(k));
+        }
+
+        std::unique_ptr<std::uint64_t[]> buffer_;
+        std::size_t                      capacity_    = 0;
+        std::uint64_t                    pending_     = 0; // producer only
+        std::uint64_t                    cached_tail_ = 0; // producer only
+        alignas(64) std::atomic<std::uint64_t> head_{0};   // bytes ever published
+        alignas(64) std::atomic<std::uint64_t> tail_{0};   // bytes ever consumed
+    };
+} // namespace internal
+
+// Turns the payload of a deferred record back into text, appending it to out
+using log_decoder = void (*)(std::string& out, const char* payload, std::size_t size);
+
+class logger {
+public:
+    // Starts the writer thread; zen::log() goes through it until stop(). Restarting stops first.
+    static void start(std::vector<std::shared_ptr<log_sink>> sinks = { std::make_shared<stdout_sink>() },
+                      log_options options = {})
+    {
+        stop();
+        auto& s = instance();
+        std::lock_guard lock(s.mutex);
+        s.sinks   = std::move(sinks);
+        s.options = options;
+        s.rings.clear();
+        s.stopping.store(false);
+        s.generation.fetch_add(1);
+        s.running.store(true, std::memory_order_release);
+        s.writer = std::thread([&s] { s.run(); });
+    }
+
+    // Writes out everything logged so far and joins the writer thread
+    static void stop() {
+        auto& s = instance();
+        {
+            std::lock_guard lock(s.mutex);
+            if (!s.running.load())
+                return;
+            s.running.store(false);
+            s.stopping.store(true);
+        }
+        s.wakeup.notify_all();
+        s.writer.join();
+        std::lock_guard lock(s.mutex);
+        s.sinks.clear();
+        s.rings.clear();
+    }
+
+    // Blocks until everything logged before the call has been written and the sinks flushed
+    static void flush() {
+        auto& s = instance();
+        std::unique_lock lock(s.mutex);
+        if (!s.running.load())
+            return;
+        const auto ticket = ++s.flush_requested;
+        s.wakeup.notify_all();
+        s.flushed_cv.wait(lock, [&] { return s.flushed >= ticket || !s.running.load(); });
+    }
+
+    static bool is_running() { return instance().running.load(std::memory_order_acquire); }
+
+    // Number of records lost to overflow_policy::drop
+    static std::uint64_t dropped() { return instance().dropped.load(std::memory_order_relaxed); }
+
+    // Queues one line (without the line end) on the calling thread's ring.
+    // Returns false if the logger isn't running or the line was dropped.
+    static bool submit(std::string_view line) {
+        auto& s = instance();
+        const in_flight guard(s);
+        if (!s.running.load())
+            return false;
+
+        auto* ring = s.this_thread_ring();
+        if (!ring)
+            return false;
+
+        if (!ring->fits(line.size())) {
+            // Rare: too large for the ring. Park the text aside and leave a marker in its place
+            // so that the writer still emits it in order with the thread's other records. The
+            // text is parked only once the marker has its room (and before it's committed):
+            // a dropped marker must not leave text behind for the next marker to pick up.
+            return s.put(*ring, 0, internal::log_record::oversized, [&](char*) {
+                std::lock_guard lock(ring->oversized_mutex);
+                ring->oversized.emplace_back(line);
+            });
+        }
+        return s.put(*ring, line.size(), internal::log_record::text, [line](char* at) {
+            std::memcpy(at, line.data(), line.size());
+        });
+    }
+
+    // Queues a record whose formatting is left to the writer thread. encode(at) must write exactly
+    // size bytes, which the writer later passes to decode() to produce the text. This is what
+    // zen::log_deferred() is built on; the hot path then only copies raw argument bytes.
+    template<class Encode>
+    static bool submit_deferred(log_decoder decode, std::size_t size, Encode&& encode) {
+        auto& s = instance();
+        const in_flight guard(s);
+        if (!s.running.load())
+            return false;
+
+        auto* ring = s.this_thread_ring();
+        if (!ring)
+            return false;
+
+        const std::size_t total = sizeof(decode) + size;
+        if (!ring->fits(total)) {
+            std::string payload(size, '\0');
+            encode(payload.data());
+            std::string text;
+            decode(text, payload.data(), payload.size());
+            return submit(text);
+        }
+        return s.put(*ring, total, internal::log_record::deferred, [&](char* at) {
+            std::memcpy(at, &decode, sizeof(decode));
+            encode(at + sizeof(decode));
+        });
+    }
+
+private:
+    struct producer {
+        std::shared_ptr<internal::log_ring> ring;
+        std::uint64_t                       generation = 0;
+        ~producer() { if (ring) ring->closed.store(true, std::memory_order_release); }
+    };
+
+    struct state {
+        std::mutex                                       mutex;
+        std::condition_variable                          wakeup;
+        std::condition_variable                          flushed_cv;
+        std::thread                                      writer;
+        std::vector<std::shared_ptr<log_sink>>           sinks;
+        std::vector<std::shared_ptr<internal::log_ring>> rings;
+        log_options                                      options;
+        std::atomic<bool>                                running{false};
+        std::atomic<bool>                                stopping{false};
+        std::atomic<std::uint64_t>                       generation{0};
+        std::atomic<std::uint64_t>                       dropped{0};
+        std::atomic<std::size_t>                         producers{0}; // threads inside submit
+        std::uint64_t                                    flush_requested = 0; // guarded by mutex
+        std::uint64_t                                    flushed         = 0; // guarded by mutex
+
+        ~state() { // in case the program never called stop()
+            if (writer.joinable()) {
+                running.store(false);
+                stopping.store(true);
+                wakeup.notify_all();
+                writer.join();
+            }
+        }
+
+        internal::log_ring* this_thread_ring() {
+            thread_local producer p;
+            const auto gen = generation.load(std::memory_order_acquire);
+            if (p.ring && p.generation == gen)
+                return p.ring.get();
+
+            std::lock_guard lock(mutex);
+            if (!running.load())
+                return nullptr;
+            if (p.ring)
+                p.ring->closed.store(true, std::memory_order_release);
+            p.ring       = std::make_shared<internal::log_ring>(options.queue_size);
+            p.generation = generation.load();
+            rings.push_back(p.ring);
+            return p.ring.get();
+        }
+
+        template<class Fill>
+        bool put(internal::log_ring& ring, std::size_t size, internal::log_record kind, Fill&& fill) {
+            char* at = ring.reserve(size, kind);
+            while (!at) {
+                if (options.overflow == overflow_policy::drop || !running.load(std::memory_order_relaxed)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                std::this_thread::yield();
+                at = ring.reserve(size, kind);
+            }
+            fill(at);
+            ring.commit();
+            return true;
+        }
+
+        // Drains every ring into the buffer and forgets the rings of exited threads
+        std::size_t drain(std::string& buffer) {
+            std::vector<std::shared_ptr<internal::log_ring>> snapshot;
+            {
+                std::lock_guard lock(mutex);
+                snapshot = rings;
+            }
+            std::size_t count = 0;
+            for (const auto& ring : snapshot) {
+                const bool closed = ring->closed.load(std::memory_order_acquire);
+                count += ring->drain([&](internal::log_record kind, std::string_view payload) {
+                    if (kind == internal::log_record::oversized) {
+                        std::lock_guard lock(ring->oversized_mutex);
+                        buffer += ring->oversized.front();
+                        ring->oversized.pop_front();
+                    } else if (kind == internal::log_record::deferred) {
+                        log_decoder decode;
+                        std::memcpy(&decode, payload.data(), sizeof(decode));
+                        decode(buffer, payload.data() + sizeof(decode), payload.size() - sizeof(decode));
+                    } else {
+                        buffer += payload;
+                    }
+                    buffer += '\n';
+                });
+                if (closed && ring->is_empty()) {
+                    std::lock_guard lock(mutex);
+                    rings.erase(std::remove(rings.begin(), rings.end(), ring), rings.end());
+                }
+            }
+            return count;
+        }
+
+        void write(std::string& buffer, bool and_flush) {
+            if (!buffer.empty())
+                for (const auto& sink : sinks)
+                    sink->write(buffer);
+            buffer.clear();
+            if (and_flush)
+                for (const auto& sink : sinks)
+                    sink->flush();
+        }
+
+        void run() {
+            std::string buffer;
+            buffer.reserve(options.buffer_size + 4096);
+            auto last_flush = std::chrono::steady_clock::now();
+
+            for (;;) {
+                std::uint64_t ticket;
+                {
+                    std::lock_guard lock(mutex);
+                    ticket = flush_requested;
+                }
+                // A producer that saw running before stop() cleared it may still be writing its
+                // record; the last drain must come after it's done. producers is read after
+                // stopping (and so after running was cleared): once it's zero, no one else gets in.
+                const bool        stop  = stopping.load();
+                const bool        busy  = producers.load() != 0;
+                const std::size_t count = drain(buffer);
+                const auto        now   = std::chrono::steady_clock::now();
+
+                const bool due = stop || ticket > flushed
+                    || (options.flush == flush_policy::every_record && count)
+                    || (options.flush == flush_policy::interval && now - last_flush >= options.flush_interval);
+
+                if (due) {
+                    write(buffer, true);
+                    last_flush = now;
+                } else if (buffer.size() >= options.buffer_size) {
+                    write(buffer, false);
+                }
+
+                if (ticket > flushed) {
+                    std::lock_guard lock(mutex);
+                    flushed = ticket;
+                    flushed_cv.notify_all();
+                }
+
+                if (stop && !count && !busy)
+                    break;
+
+                if (stop && !count) {
+                    std::this_thread::yield(); // waiting on the producers still in submit
+                } else if (!count) {
+                    std::unique_lock lock(mutex);
+                    wakeup.wait_for(lock, std::chrono::milliseconds(1), [&] { return stopping.load() || flush_requested > flushed; });
+                }
+            }
+            std::lock_guard lock(mutex);
+            flushed = flush_requested;
+            flushed_cv.notify_all();
+        }
+    };
+
+    // Marks the calling thread as inside submit for the writer's final drain
+    struct in_flight {
+        state& s;
+        explicit in_flight(state& s) : s(s) { s.producers.fetch_add(1); }
+        ~in_flight() { s.producers.fetch_sub(1, std::memory_order_release); }
+    };
+
+    static state& instance() {
+        static state s;
+        return s;
+    }
+};
+
+} // namespace zen
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <iterator>
+#include <cstddef>
 #include <vector>
 #include <map>
 
@@ -45,23 +47,86 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////////////////// zen::multimap
 
+namespace internal {
+    // The values of a range of map elements, e.g. of an equal_range(): a view that copies
+    // nothing unless converted to a vector
+    template<class It>
+    class mapped_range {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = typename std::iterator_traits<It>::value_type::second_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = decltype((std::declval<It>()->second));
+            using pointer           = std::remove_reference_t<reference>*;
+
+            iterator() = default;
+            explicit iterator(It it) : it_(it) {}
+
+            reference operator*()  const { return it_->second; }
+            pointer   operator->() const { return &it_->second; }
+
+            iterator& operator++() { ++it_; return *this; }
+            iterator& operator--() { --it_; return *this; }
+            iterator  operator++(int) { iterator i = *this; ++it_; return i; }
+            iterator  operator--(int) { iterator i = *this; --it_; return i; }
+
+            friend bool operator==(const iterator& a, const iterator& b) { return a.it_ == b.it_; }
+            friend bool operator!=(const iterator& a, const iterator& b) { return a.it_ != b.it_; }
+
+        private:
+            It it_;
+        };
+
+        using value_type = typename iterator::value_type;
+        using reference  = typename iterator::reference;
+        using size_type  = std::size_t;
+
+        mapped_range(It first, It last) : first_(first), last_(last) {}
+        explicit mapped_range(std::pair<It, It> range) : mapped_range(range.first, range.second) {}
+
+        iterator begin() const { return iterator(first_); }
+        iterator end()   const { return iterator(last_); }
+
+        bool      empty()    const { return first_ == last_; }
+        bool      is_empty() const { return first_ == last_; }
+        size_type size()     const { return static_cast<size_type>(std::distance(first_, last_)); }
+
+        reference front() const { return first_->second; }
+
+        // Walks n elements from the first one: fine for the few values of a key
+        reference operator[](size_type n) const { return std::next(first_, static_cast<std::ptrdiff_t>(n))->second; }
+
+        std::vector<value_type> to_vector() const { return std::vector<value_type>(begin(), end()); }
+
+        operator std::vector<value_type>() const { return to_vector(); }
+
+    private:
+        It first_;
+        It last_;
+    };
+} // namespace internal
+
 template<class K, class V, class C = std::less<K>, class A = std::allocator<std::pair<const K, V>>>
 class multimap : public std::multimap<K, V, C, A>, private zen::stackonly
 {
 public:
     using std::multimap<K, V, C, A>::multimap; // inherit constructors, has to be explicit
 
+    using values_view       = internal::mapped_range<typename std::multimap<K, V, C, A>::iterator>;
+    using const_values_view = internal::mapped_range<typename std::multimap<K, V, C, A>::const_iterator>;
+
     // std::map::operator[] is not defined, but
-    // zen::map::operator[] returns an std::vector
-    // composed of values corresponding to the parameter key.
-    std::vector<V> operator[](const K& key) {
-        auto range = my::equal_range(key);
-        std::vector<V> values;
-        for (auto it = range.first; it != range.second; ++it) {
-            values.push_back(it->second);
-        }
-        return values;
-    }
+    // zen::multimap::operator[] returns a view of the
+    // values corresponding to the parameter key. It
+    // converts to an std::vector of them when needed.
+    // Example: std::vector<V> v = mm["key"];
+    values_view       operator[](const K& key)       { return values_view(my::equal_range(key)); }
+    const_values_view operator[](const K& key) const { return const_values_view(my::equal_range(key)); }
+
+    // Number of values corresponding to the key
+    std::size_t count_of(const K& key) const { return my::count(key); }
 
     bool is_empty() const { return my::empty(); }
 
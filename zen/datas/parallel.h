@@ -0,0 +1,277 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <type_traits>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <deque>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::exec
+
+// Execution policies, in the spirit of std::execution, for the zen algorithms that take one.
+// With seq, everything runs on the calling thread. With par (and par_unseq, which is the same
+// here since the loops are already written for vectorization), large enough inputs are split
+// across the threads of a built-in pool; small inputs stay serial, where threads would cost
+// more than they save. This doesn't need the TBB that std::execution::par needs with libstdc++.
+// Example: zen::sum(zen::exec::par, v);
+namespace exec {
+    struct sequenced_policy {};
+    struct parallel_policy {};
+    struct parallel_unsequenced_policy {};
+
+    inline constexpr sequenced_policy            seq{};
+    inline constexpr parallel_policy             par{};
+    inline constexpr parallel_unsequenced_policy par_unseq{};
+
+    template<class T>
+    constexpr bool is_execution_policy_v = std::is_same_v<std::decay_t<T>, sequenced_policy>
+                                        || std::is_same_v<std::decay_t<T>, parallel_policy>
+                                        || std::is_same_v<std::decay_t<T>, parallel_unsequenced_policy>;
+} // namespace exec
+
+///////////////////////////////////////////////////////////////////////////////////////////// parallel helpers
+
+namespace internal {
+    // A fixed set of worker threads (one less than the hardware threads, since the thread
+    // that submits work takes part in it) shared by all the zen parallel algorithms, so that
+    // they don't pay for creating threads on every call.
+    class thread_pool {
+    public:
+        static thread_pool& instance() {
+            static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return pool;
+        }
+
+        std::size_t workers() const { return threads_.size(); }
+
+        // Runs task(0), ..., task(n - 1) and returns when all of them are done. The calling
+        // thread runs tasks too. Calls from inside a task run serially, which rules out deadlocks
+        // of tasks waiting for tasks queued behind them. The first exception thrown is rethrown.
+        template<class Task>
+        void run(std::size_t n, Task&& task) {
+            if (n == 0)
+                return;
+            if (n == 1 || threads_.empty() || inside_task()) {
+                std::exception_ptr error;
+                for (std::size_t i = 0; i < n; ++i) {
+                    try { task(i); } catch (...) { if (!error) error = std::current_exception(); }
+                }
+                if (error)
+                    std::rethrow_exception(error);
+                return;
+            }
+
+            batch b;
+            b.pending = n;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (std::size_t i = 1; i < n; ++i)
+                    queue_.push_back([&b, &task, i] { b.execute([&] { task(i); }); });
+            }
+            wake_.notify_all();
+
+            b.execute([&] { task(0); });
+
+            // Help with whatever is still queued rather than just wait
+            while (auto job = try_pop())
+                job();
+
+            std::unique_lock<std::mutex> lock(b.mutex);
+            b.done.wait(lock, [&] { return b.pending == 0; });
+            if (b.error)
+                std::rethrow_exception(b.error);
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& t : threads_)
+                t.join();
+        }
+
+    private:
+        struct batch {
+            std::mutex              mutex;
+            std::condition_variable done;
+            std::size_t             pending = 0;
+            std::exception_ptr      error;
+
+            template<class F>
+            void execute(F&& f) {
+                std::exception_ptr e;
+                {
+                    task_scope scope;
+                    try { f(); } catch (...) { e = std::current_exception(); }
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (e && !error)
+                    error = e;
+                if (--pending == 0)
+                    done.notify_all();
+            }
+        };
+
+        struct task_scope {
+            const bool outer = !inside_task();
+            task_scope()  { inside_task() = true; }
+            ~task_scope() { if (outer) inside_task() = false; }
+        };
+
+        static bool& inside_task() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        explicit thread_pool(std::size_t n) {
+            threads_.reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+                threads_.emplace_back([this] { work(); });
+        }
+
+        std::function<void()> try_pop() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty())
+                return nullptr;
+            auto job = std::move(queue_.front());
+            queue_.pop_front();
+            return job;
+        }
+
+        void work() {
+            for (;;) {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty())
+                        return; // stopping
+                    job = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                job();
+            }
+        }
+
+        std::vector<std::thread>          threads_;
+        std::deque<std::function<void()>> queue_;
+        std::mutex                        mutex_;
+        std::condition_variable           wake_;
+        bool                              stopping_ = false;
+    };
+
+    // The smallest piece worth giving a thread of its own under a policy: the given
+    // threshold for the parallel policies, and "never" for the sequenced one
+    template<class Policy>
+    constexpr std::size_t min_piece(const Policy&, std::size_t threshold) {
+        return std::is_same_v<Policy, exec::sequenced_policy> ? std::numeric_limits<std::size_t>::max() : threshold;
+    }
+
+    // Below this many elements per thread, searching and formatting aren't worth splitting up
+    constexpr std::size_t parallel_search_threshold = 1 << 16;
+    constexpr std::size_t parallel_format_threshold = 1 << 14;
+
+    // How many pieces of at least min_piece elements [0, n) is worth splitting into
+    inline std::size_t piece_count(std::size_t n, std::size_t min_piece) {
+        const std::size_t threads = thread_pool::instance().workers() + 1;
+        return std::max<std::size_t>(1, std::min(threads, n / std::max<std::size_t>(min_piece, 1)));
+    }
+
+    // Splits [0, n) into contiguous pieces of at least min_piece elements, one per thread
+    // at most, and calls work(piece, begin, end) on each piece in parallel on the thread pool.
+    // Returns once all pieces are done.
+    template<class Work>
+    void parallel_indexed_pieces(std::size_t n, std::size_t min_piece, Work&& work) {
+        const std::size_t pieces = piece_count(n, min_piece);
+        if (pieces == 1) {
+            work(std::size_t{0}, std::size_t{0}, n);
+            return;
+        }
+        thread_pool::instance().run(pieces, [&](std::size_t p) {
+            work(p, n * p / pieces, n * (p + 1) / pieces);
+        });
+    }
+
+    // Same as above, for work that doesn't need to know which piece it got: work(begin, end)
+    template<class Work>
+    void parallel_pieces(std::size_t n, std::size_t min_piece, Work&& work) {
+        parallel_indexed_pieces(n, min_piece, [&work](std::size_t, std::size_t begin, std::size_t end) {
+            work(begin, end);
+        });
+    }
+
+    // Reduces [0, n) piecewise in parallel: reduce(begin, end) gives each piece's partial
+    // result, and the partials are then folded left to right with combine(a, b)
+    template<class T, class Reduce, class Combine>
+    T parallel_reduce(std::size_t n, std::size_t min_piece, Reduce&& reduce, Combine&& combine) {
+        std::vector<T> partials(piece_count(n, min_piece));
+        parallel_indexed_pieces(n, min_piece, [&](std::size_t piece, std::size_t begin, std::size_t end) {
+            partials[piece] = reduce(begin, end);
+        });
+        T result = partials[0];
+        for (std::size_t p = 1; p < partials.size(); ++p)
+            result = combine(result, partials[p]);
+        return result;
+    }
+
+    // Whether test(begin, end) holds for any piece of [0, n). Pieces are tested in blocks of
+    // block elements, and all threads stop early once one of them has found a match.
+    template<class Test>
+    bool parallel_any(std::size_t n, std::size_t min_piece, std::size_t block, Test&& test) {
+        std::atomic<bool> found{ false };
+        parallel_pieces(n, min_piece, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end && !found.load(std::memory_order_relaxed); i += block) {
+                if (test(i, std::min(end, i + block))) {
+                    found.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        return found.load();
+    }
+
+    // Whether any of the n elements at p satisfies pred, searched in parallel for large n
+    template<class T, class Pred>
+    bool parallel_contains(const T* p, std::size_t n, std::size_t min_piece, Pred&& pred) {
+        return parallel_any(n, min_piece, parallel_search_threshold / 4, [&](std::size_t begin, std::size_t end) {
+            return std::find_if(p + begin, p + end, pred) != p + end;
+        });
+    }
+} // namespace internal
+
+} // namespace zen
@@ -0,0 +1,249 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <array>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+#include "timer.h" // internal; will not be included in kaizen.h
+
+#if defined(__linux__)
+#   include <linux/perf_event.h>
+#   include <sys/syscall.h>
+#   include <sys/ioctl.h>
+#   include <unistd.h>
+#endif
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::perf_counters
+
+// Hardware event counts of a measured region. Counters that couldn't be opened read as 0.
+struct perf_counts {
+    std::uint64_t cycles        = 0;
+    std::uint64_t instructions  = 0;
+    std::uint64_t cache_misses  = 0;
+    std::uint64_t branch_misses = 0;
+    bool          available     = false; // false if no counter could be opened at all
+
+    double ipc() const { return cycles ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0; }
+};
+
+// Counts CPU cycles, instructions, cache misses and branch misses of the calling thread
+// (user space only) through Linux perf_event_open(). Like zen::timer, counting starts on
+// construction and stop() returns what was counted since. Where perf events aren't permitted
+// (kernel.perf_event_paranoid, containers, virtual machines without a PMU) or on other
+// systems, is_available() is false and all counts are 0, so the calling code needs no #ifdefs.
+// Example: zen::perf_counters pc;
+//          work();
+//          auto c = pc.stop();
+// Result:  c.ipc(), c.cache_misses, ...
+class perf_counters : private zen::stackonly {
+public:
+    perf_counters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, events> config = {{
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES       },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS     },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES     },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES    },
+        }};
+        for (std::size_t i = 0; i < events; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = config[i].first;
+            attr.config         = config[i].second;
+            attr.disabled       = leader_ < 0 ? 1 : 0; // the group leader starts all of them at once
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                                | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0)
+                continue; // this one isn't permitted or supported, the others may still be
+            if (leader_ < 0)
+                leader_ = fd;
+            fds_[i] = fd;
+            ioctl(fd, PERF_EVENT_IOC_ID, &ids_[i]);
+        }
+#endif
+        start();
+    }
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for (int fd : fds_)
+            if (fd >= 0) close(fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&)            = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool is_available() const { return leader_ >= 0; }
+
+    // Zeroes and (re)starts all counters
+    void start() {
+#if defined(__linux__)
+        if (leader_ < 0) return;
+        ioctl(leader_, PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stops counting and returns the counts since start()
+    perf_counts stop() {
+#if defined(__linux__)
+        if (leader_ >= 0)
+            ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        return read();
+    }
+
+    // Counts so far, scaled up if the kernel had to multiplex the counters
+    perf_counts read() const {
+        perf_counts c;
+#if defined(__linux__)
+        if (leader_ < 0) return c;
+
+        struct { std::uint64_t value, id; } entries[events];
+        struct { std::uint64_t nr, time_enabled, time_running; } header;
+        char buffer[sizeof(header) + sizeof(entries)];
+
+        if (::read(leader_, buffer, sizeof(buffer)) < static_cast<ssize_t>(sizeof(header)))
+            return c;
+        std::memcpy(&header, buffer, sizeof(header));
+        std::memcpy(entries, buffer + sizeof(header), sizeof(entries));
+
+        const double scale = header.time_running
+            ? static_cast<double>(header.time_enabled) / static_cast<double>(header.time_running) : 1.0;
+
+        std::array<std::uint64_t, events> values{};
+        for (std::uint64_t n = 0; n < header.nr && n < events; ++n)
+            for (std::size_t i = 0; i < events; ++i)
+                if (fds_[i] >= 0 && ids_[i] == entries[n].id)
+                    values[i] = static_cast<std::uint64_t>(static_cast<double>(entries[n].value) * scale);
+
+        c.cycles        = values[0];
+        c.instructions  = values[1];
+        c.cache_misses  = values[2];
+        c.branch_misses = values[3];
+        c.available     = true;
+#endif
+        return c;
+    }
+
+private:
+    static constexpr std::size_t events = 4;
+
+    std::array<int,           events> fds_{};
+    std::array<std::uint64_t, events> ids_{};
+    int                               leader_ = -1;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::counted_timer
+
+// A zen::timer that also counts hardware events over the same region. It's a separate type
+// rather than a zen::timer option so that plain timers don't pay for opening the counters.
+// The counters start before and stop after the clock reads, so they cover the timed region.
+// Example: zen::counted_timer t;
+//          work();
+//          t.stop();
+// Result:  t.duration_string(), t.counts().ipc(), t.counts().cache_misses, ...
+template<class Clock = std::chrono::high_resolution_clock>
+class basic_counted_timer : public basic_timer<Clock>, private zen::stackonly {
+public:
+    basic_counted_timer() { basic_timer<Clock>::start(); } // restart the clock after the counters
+
+    basic_counted_timer& start() { counters_.start(); basic_timer<Clock>::start(); return *this; }
+    basic_counted_timer& stop()  { basic_timer<Clock>::stop(); counts_ = counters_.stop(); return *this; }
+
+    // Counts between start (or construction) and the last stop()
+    const perf_counts& counts() const { return counts_; }
+
+private:
+    perf_counters counters_;
+    perf_counts   counts_;
+};
+
+using counted_timer     = basic_counted_timer<>;
+using counted_tsc_timer = basic_counted_timer<tsc_clock>;
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::benchmark
+
+// Wall time and hardware counts of a batch of runs, reported per run
+struct benchmark_result {
+    std::size_t                              iterations = 0;
+    std::chrono::duration<double, std::nano> per_iteration{};
+    perf_counts                              counts;
+
+    double ipc()                         const { return counts.ipc(); }
+    double cache_misses_per_iteration()  const { return per_run(counts.cache_misses);  }
+    double branch_misses_per_iteration() const { return per_run(counts.branch_misses); }
+
+    // Example: zen::log("HASH:", zen::benchmark(hash_op, 1'000'000).to_string());
+    // Result:  HASH: 4.82 ns/iter, IPC 3.12, 0.0001 cache misses/iter, 0.0020 branch misses/iter
+    std::string to_string() const {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2) << per_iteration.count() << " ns/iter";
+        if (!counts.available)
+            return os.str() + " (perf counters unavailable)";
+        os << ", IPC " << ipc() << std::setprecision(4)
+           << ", "     << cache_misses_per_iteration()  << " cache misses/iter"
+           << ", "     << branch_misses_per_iteration() << " branch misses/iter";
+        return os.str();
+    }
+
+private:
+    double per_run(std::uint64_t n) const { return iterations ? static_cast<double>(n) / static_cast<double>(iterations) : 0.0; }
+};
+
+// Like zen::measure_execution(operation, iterations), with hardware counters next to the time
+// Example: auto r = zen::benchmark([&]{ zen::do_not_optimize(hash(x)); }, 1'000'000);
+template<class Operation>
+benchmark_result benchmark(Operation&& operation, std::size_t iterations = 1)
+{
+    benchmark_result r;
+    r.iterations = iterations;
+
+    perf_counters pc;
+    timer         t;
+    for (std::size_t i = 0; i < iterations; ++i)
+        std::invoke(operation);
+    t.stop();
+    r.counts = pc.stop();
+
+    r.per_iteration = std::chrono::duration<double, std::nano>(t.duration<timer::nsec>()) / static_cast<double>(iterations ? iterations : 1);
+    return r;
+}
+
+} // namespace zen
@@ -0,0 +1,388 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <filesystem>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <array>
+#include <mutex>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+#include "timer.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::profiler
+
+// Hot-path profiling zones. Each ZEN_PROFILE_SCOPE() times its enclosing scope with a zen::tsc_timer
+// and records the result into buffers owned by the current thread, so recording takes no locks.
+// Every thread keeps per-zone aggregates (count, total, min, max and a log2 latency histogram)
+// along with a ring of its most recent events for traces. When a thread exits, its data is folded
+// into a process-wide summary, so nothing is lost. The macro compiles to nothing unless
+// ZEN_ENABLE_PROFILING is defined before including kaizen.h.
+// Example: void parse() { ZEN_PROFILE_SCOPE("parse"); ... }
+//          zen::log(zen::profiler::table());                // aggregated table
+//          zen::profiler::write_chrome_trace("trace.json"); // for chrome://tracing or ui.perfetto.dev
+
+#ifndef ZEN_PROFILE_MAX_ZONES
+#define ZEN_PROFILE_MAX_ZONES 1024 // distinct zones (call sites) per program
+#endif
+
+#ifndef ZEN_PROFILE_RING_SIZE
+#define ZEN_PROFILE_RING_SIZE 4096 // most recent events kept per thread for traces
+#endif
+
+#define ZEN_CONCAT_IMPL(a, b) a##b
+#define ZEN_CONCAT(a, b) ZEN_CONCAT_IMPL(a, b)
+
+#if defined(ZEN_ENABLE_PROFILING)
+#define ZEN_PROFILE_SCOPE(name) \
+    static const std::uint32_t ZEN_CONCAT(zen_profile_zone_, __LINE__) = zen::profiler::register_zone(name); \
+    const zen::profile_scope   ZEN_CONCAT(zen_profile_scope_, __LINE__)(ZEN_CONCAT(zen_profile_zone_, __LINE__))
+#else
+#define ZEN_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
+
+// Aggregated measurements of one zone, as reported by zen::profiler::stats()
+struct zone_stats {
+    static constexpr std::size_t buckets = 40; // bucket i counts durations in [2^i, 2^(i+1)) ns
+
+    std::string   name;
+    std::uint64_t count    = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t min_ns   = 0;
+    std::uint64_t max_ns   = 0;
+    std::array<std::uint64_t, buckets> histogram{};
+
+    double mean_ns() const { return count ? static_cast<double>(total_ns) / static_cast<double>(count) : 0.0; }
+
+    // Upper bound of the histogram bucket that contains the p-th percentile (p in [0, 100])
+    std::uint64_t percentile_ns(double p) const {
+        if (!count) return 0;
+        const auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets; ++i) {
+            seen += histogram[i];
+            if (seen >= rank)
+                return std::min<std::uint64_t>(max_ns, (std::uint64_t(2) << i) - 1);
+        }
+        return max_ns;
+    }
+
+    static std::size_t bucket_of(std::uint64_t ns) {
+        std::size_t b = 0;
+        while (ns > 1 && b < buckets - 1) { ns >>= 1; ++b; }
+        return b;
+    }
+};
+
+namespace internal {
+    // Written only by the owning thread, read by anyone: relaxed atomics let the readers
+    // see consistent words while the owner pays no more than for plain loads and stores.
+    struct profile_counters {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> total_ns{0};
+        std::atomic<std::uint64_t> min_ns{UINT64_MAX};
+        std::atomic<std::uint64_t> max_ns{0};
+        std::array<std::atomic<std::uint64_t>, zone_stats::buckets> histogram{};
+
+        static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        void add(std::uint64_t ns) {
+            bump(count, 1);
+            bump(total_ns, ns);
+            if (ns < min_ns.load(std::memory_order_relaxed)) min_ns.store(ns, std::memory_order_relaxed);
+            if (ns > max_ns.load(std::memory_order_relaxed)) max_ns.store(ns, std::memory_order_relaxed);
+            bump(histogram[zone_stats::bucket_of(ns)], 1);
+        }
+
+        void merge_into(zone_stats& s) const {
+            const auto n = count.load(std::memory_order_relaxed);
+            if (!n) return;
+            const auto lo = min_ns.load(std::memory_order_relaxed);
+            const auto hi = max_ns.load(std::memory_order_relaxed);
+            s.min_ns    = s.count ? std::min(s.min_ns, lo) : lo;
+            s.max_ns    = std::max(s.max_ns, hi);
+            s.count    += n;
+            s.total_ns += total_ns.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < zone_stats::buckets; ++i)
+                s.histogram[i] += histogram[i].load(std::memory_order_relaxed);
+        }
+
+        void clear() {
+            count.store(0, std::memory_order_relaxed);
+            total_ns.store(0, std::memory_order_relaxed);
+            min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+            max_ns.store(0, std::memory_order_relaxed);
+            for (auto& h : histogram) h.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct profile_event {
+        std::uint32_t zone     = 0;
+        std::uint32_t tid      = 0;
+        std::uint64_t begin_ns = 0;
+        std::uint64_t dur_ns   = 0;
+    };
+
+    // One slot of a per-thread ring. Fields are atomic for the same reason as above;
+    // a trace taken while the thread is busy may contain a few half-overwritten events.
+    struct profile_slot {
+        std::atomic<std::uint32_t> zone{0};
+        std::atomic<std::uint64_t> begin_ns{0};
+        std::atomic<std::uint64_t> dur_ns{0};
+    };
+
+    struct profile_thread;
+
+    struct profile_registry {
+        std::mutex                   mutex;
+        std::vector<std::string>     names;
+        std::vector<profile_thread*> live;
+        std::vector<zone_stats>      retired;        // totals of threads that have exited
+        std::vector<profile_event>   retired_events; // their last events, for traces
+        std::uint32_t                next_tid = 0;
+
+        static constexpr std::size_t max_retired_events = std::size_t(1) << 20;
+    };
+
+    inline profile_registry& profiler_registry() {
+        static profile_registry r;
+        return r;
+    }
+
+    struct profile_thread {
+        std::uint32_t tid;
+        std::array<std::atomic<profile_counters*>, ZEN_PROFILE_MAX_ZONES> zones{};
+        std::vector<profile_slot>  ring = std::vector<profile_slot>(ZEN_PROFILE_RING_SIZE);
+        std::atomic<std::uint64_t> head{0}; // total number of events ever written
+
+        profile_thread() {
+            auto& r = profiler_registry();
+            std::lock_guard lock(r.mutex);
+            tid = r.next_tid++;
+            r.live.push_back(this);
+        }
+
+        ~profile_thread() {
+            auto& r = profiler_registry();
+            {
+                std::lock_guard lock(r.mutex);
+                for (std::size_t z = 0; z < zones.size(); ++z) {
+                    if (auto* c = zones[z].load(std::memory_order_acquire)) {
+                        if (r.retired.size() <= z) r.retired.resize(z + 1);
+                        c->merge_into(r.retired[z]);
+                    }
+                }
+                collect_events(r.retired_events, profile_registry::max_retired_events);
+                r.live.erase(std::remove(r.live.begin(), r.live.end(), this), r.live.end());
+            }
+            for (auto& z : zones)
+                delete z.load(std::memory_order_relaxed);
+        }
+
+        void record(std::uint32_t zone, std::uint64_t begin_ns, std::uint64_t dur_ns) {
+            auto* c = zones[zone].load(std::memory_order_relaxed);
+            if (!c) {
+                c = new profile_counters;
+                zones[zone].store(c, std::memory_order_release);
+            }
+            c->add(dur_ns);
+
+            const auto h = head.load(std::memory_order_relaxed);
+            auto& slot = ring[h % ring.size()];
+            slot.zone.store(zone, std::memory_order_relaxed);
+            slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+            slot.dur_ns.store(dur_ns, std::memory_order_relaxed);
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        void collect_events(std::vector<profile_event>& out, std::size_t limit) const {
+            const auto h = head.load(std::memory_order_acquire);
+            const auto n = std::min<std::uint64_t>(h, ring.size());
+            for (auto i = h - n; i < h && out.size() < limit; ++i) {
+                const auto& slot = ring[i % ring.size()];
+                out.push_back({ slot.zone.load(std::memory_order_relaxed), tid,
+                                slot.begin_ns.load(std::memory_order_relaxed),
+                                slot.dur_ns.load(std::memory_order_relaxed) });
+            }
+        }
+    };
+
+    inline profile_thread& this_profile_thread() {
+        thread_local profile_thread t;
+        return t;
+    }
+} // namespace internal
+
+class profiler {
+public:
+    // Called once per call site by ZEN_PROFILE_SCOPE; the returned id indexes per-thread buffers
+    static std::uint32_t register_zone(const char* name) {
+        auto& r = internal::profiler_registry();
+        std::lock_guard lock(r.mutex);
+        if (r.names.size() >= ZEN_PROFILE_MAX_ZONES)
+            return ZEN_PROFILE_MAX_ZONES; // out of zones: recorded as a no-op
+        r.names.emplace_back(name);
+        return static_cast<std::uint32_t>(r.names.size() - 1);
+    }
+
+    static void record(std::uint32_t zone, std::uint64_t begin_ns, std::uint64_t dur_ns) {
+        if (zone < ZEN_PROFILE_MAX_ZONES)
+            internal::this_profile_thread().record(zone, begin_ns, dur_ns);
+    }
+
+    // Totals of all zones across exited and still running threads, in registration order
+    static std::vector<zone_stats> stats() {
+        auto& r = internal::profiler_registry();
+        std::lock_guard lock(r.mutex);
+
+        std::vector<zone_stats> result(r.names.size());
+        for (std::size_t z = 0; z < result.size(); ++z) {
+            if (z < r.retired.size())
+                result[z] = r.retired[z];
+            result[z].name = r.names[z];
+            for (const auto* t : r.live)
+                if (const auto* c = t->zones[z].load(std::memory_order_acquire))
+                    c->merge_into(result[z]);
+        }
+        return result;
+    }
+
+    // A fixed-width table of all zones that have been entered at least once
+    static std::string table() {
+        std::ostringstream os;
+        os << std::left  << std::setw(24) << "ZONE"
+           << std::right << std::setw(10) << "COUNT"
+           << std::setw(14) << "TOTAL(ns)" << std::setw(12) << "MEAN(ns)"
+           << std::setw(12) << "MIN(ns)"   << std::setw(12) << "MAX(ns)"
+           << std::setw(12) << "P50(ns)"   << std::setw(12) << "P99(ns)";
+        for (const auto& s : stats()) {
+            if (!s.count) continue;
+            os << '\n'
+               << std::left  << std::setw(24) << s.name
+               << std::right << std::setw(10) << s.count
+               << std::setw(14) << s.total_ns
+               << std::setw(12) << static_cast<std::uint64_t>(s.mean_ns())
+               << std::setw(12) << s.min_ns << std::setw(12) << s.max_ns
+               << std::setw(12) << s.percentile_ns(50) << std::setw(12) << s.percentile_ns(99);
+        }
+        return os.str();
+    }
+
+    // Writes the most recent events of every thread in the Chrome trace event format
+    static bool write_chrome_trace(const std::filesystem::path& path) {
+        std::vector<internal::profile_event> events;
+        std::vector<std::string>             names;
+        {
+            auto& r = internal::profiler_registry();
+            std::lock_guard lock(r.mutex);
+            names  = r.names;
+            events = r.retired_events;
+            for (const auto* t : r.live)
+                t->collect_events(events, events.size() + ZEN_PROFILE_RING_SIZE);
+        }
+
+        std::ofstream file(path);
+        if (!file)
+            return false;
+
+        std::uint64_t origin = UINT64_MAX;
+        for (const auto& e : events)
+            origin = std::min(origin, e.begin_ns);
+
+        file << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const auto& e = events[i];
+            file << (i ? ",\n" : "\n")
+                 << "{\"name\":\"" << json_escape(e.zone < names.size() ? names[e.zone] : "?") << "\""
+                 << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+                 << ",\"ts\":"  << static_cast<double>(e.begin_ns - origin) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(e.dur_ns)            / 1000.0 << "}";
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+    // Forgets all measurements but keeps the registered zones.
+    // Meant for quiet moments; concurrent recordings may survive it.
+    static void reset() {
+        auto& r = internal::profiler_registry();
+        std::lock_guard lock(r.mutex);
+        r.retired.clear();
+        r.retired_events.clear();
+        for (auto* t : r.live) {
+            for (auto& z : t->zones)
+                if (auto* c = z.load(std::memory_order_acquire))
+                    c->clear();
+            t->head.store(0, std::memory_order_release);
+        }
+    }
+
+private:
+    static std::string json_escape(const std::string& s) {
+        std::string out;
+        for (const char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+        return out;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::profile_scope
+
+// Measures its own lifetime and records it under the given zone on destruction.
+// Normally created through ZEN_PROFILE_SCOPE(), but usable directly as well.
+// Example: static const auto zone = zen::profiler::register_zone("flush");
+//          zen::profile_scope scope(zone);
+class profile_scope : private zen::stackonly {
+public:
+    explicit profile_scope(std::uint32_t zone) : zone_(zone) {}
+
+    ~profile_scope() {
+        timer_.stop();
+        profiler::record(zone_,
+            static_cast<std::uint64_t>(timer_.started_at().time_since_epoch().count()),
+            static_cast<std::uint64_t>(timer_.duration<tsc_timer::nsec>().count()));
+    }
+
+    profile_scope(const profile_scope&)            = delete;
+    profile_scope& operator=(const profile_scope&) = delete;
+
+private:
+    std::uint32_t zone_;
+    tsc_timer     timer_;
+};
+
+} // namespace zen
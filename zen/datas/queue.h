@@ -22,9 +22,16 @@
 
 #pragma once
 
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <vector>
 #include <queue>
 
-#include "alpha.h" // internal; will not be included in kaizen.h
+#include "alpha.h"    // internal; will not be included in kaizen.h
+#include "concepts.h" // internal; will not be included in kaizen.h
 
 namespace zen {
 
@@ -36,11 +43,10 @@ class queue : public std::queue<T, C>, private zen::stackonly
 public:
     using std::queue<T, C>::queue; // inherit constructors, has to be explicit
     
-    template<class Iterable>
+    // (an Iterable, so that other arguments still find the inherited constructors)
+    template<class Iterable, class = std::enable_if_t<zen::is_iterable_v<Iterable>>>
     queue(const Iterable& c)
     {
-        ZEN_STATIC_ASSERT(zen::is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
-
         for (const auto& x : c)
             my::push(x);
     }
@@ -53,6 +59,36 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////////////////// zen::priority_queue
 
+namespace internal {
+    template<class C>
+    using has_reserve_t = decltype(std::declval<C&>().reserve(std::size_t()));
+
+    template<class C, class = void> struct has_reserve : std::false_type {};
+    template<class C> struct has_reserve<C, std::void_t<has_reserve_t<C>>> : std::true_type {};
+
+    // Appends the elements of an iterable (moving them out of an rvalue) to a container,
+    // making room for them once when the size is known up front
+    template<class C, class Iterable>
+    void append_range(C& c, Iterable&& range) {
+        if constexpr (has_reserve<C>::value && std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<decltype(std::begin(range))>::iterator_category>)
+            c.reserve(c.size() + static_cast<std::size_t>(std::distance(std::begin(range), std::end(range))));
+        if constexpr (std::is_rvalue_reference_v<Iterable&&>)
+            c.insert(c.end(), std::make_move_iterator(std::begin(range)), std::make_move_iterator(std::end(range)));
+        else
+            c.insert(c.end(), std::begin(range), std::end(range));
+    }
+
+    // Whether restoring the heap property over n elements after appending k is cheaper by
+    // rebuilding the heap (linear in n) than by sifting the k new elements up (k log n)
+    inline bool rebuild_heap_after_append(std::size_t n, std::size_t k) {
+        std::size_t log_n = 1;
+        while ((std::size_t(1) << log_n) < n)
+            ++log_n;
+        return k * log_n > n;
+    }
+} // namespace internal
+
 template<
     class T,
     class C = std::vector<T>,
@@ -63,13 +99,47 @@ class priority_queue : public std::priority_queue<T, C, L>, private zen::stackon
 public:
     using std::priority_queue<T, C, L>::priority_queue; // inherit constructors, has to be explicit
 
+    // Copies (or moves, from an rvalue) the elements in one go and builds the heap in linear time
+    // (an Iterable that isn't a priority_queue, so that copies and the inherited constructors still apply)
+    template<class Iterable, class = std::enable_if_t<zen::is_iterable_v<std::decay_t<Iterable>> &&
+                                                      !std::is_base_of_v<std::priority_queue<T, C, L>, std::decay_t<Iterable>>>>
+    priority_queue(Iterable&& c)
+    {
+        internal::append_range(my::c, std::forward<Iterable>(c));
+        std::make_heap(my::c.begin(), my::c.end(), my::comp);
+    }
+
+    // Pushes all elements of an iterable, rebuilding the heap at once when that's cheaper
+    // Example: q.push_range(zen::ints{ 4, 2, 7 });
     template<class Iterable>
-    priority_queue(const Iterable& c)
+    void push_range(Iterable&& range)
     {
-        ZEN_STATIC_ASSERT(zen::is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+        ZEN_STATIC_ASSERT(zen::is_iterable_v<std::decay_t<Iterable>>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
 
-        for (const auto& x : c)
-            my::push(x);
+        const std::size_t n = my::c.size();
+        internal::append_range(my::c, std::forward<Iterable>(range));
+        if (internal::rebuild_heap_after_append(my::c.size(), my::c.size() - n)) {
+            std::make_heap(my::c.begin(), my::c.end(), my::comp);
+        } else {
+            for (auto it = my::c.begin() + static_cast<std::ptrdiff_t>(n); it != my::c.end(); )
+                std::push_heap(my::c.begin(), ++it, my::comp);
+        }
+    }
+
+    // Pops the k top elements (or all, if there are fewer) and returns them in order
+    // Example: zen::priority_queue<int>(zen::ints{ 3, 9, 1, 5 }).pop_n(2);
+    // Result: { 9, 5 }
+    std::vector<T> pop_n(std::size_t k)
+    {
+        k = std::min(k, my::c.size());
+        std::vector<T> top;
+        top.reserve(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            std::pop_heap(my::c.begin(), my::c.end(), my::comp);
+            top.push_back(std::move(my::c.back()));
+            my::c.pop_back();
+        }
+        return top;
     }
 
     bool is_empty() const { return my::empty(); }
@@ -78,4 +148,162 @@ private:
     using my = priority_queue<T, C, L>;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////// zen::d_ary_priority_queue
+
+namespace internal {
+    // Heap operations where each node has D children: a 4-ary heap is half as deep as a binary
+    // one, and the 4 children that each level compares sit next to each other in memory
+    template<std::size_t D, class It, class L>
+    void d_ary_sift_up(It first, std::size_t i, L& less) {
+        auto x = std::move(first[i]);
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / D;
+            if (!less(first[parent], x))
+                break;
+            first[i] = std::move(first[parent]);
+            i = parent;
+        }
+        first[i] = std::move(x);
+    }
+
+    template<std::size_t D, class It, class L>
+    void d_ary_sift_down(It first, std::size_t n, std::size_t i, L& less) {
+        auto x = std::move(first[i]);
+        for (std::size_t child = D * i + 1; child < n; child = D * i + 1) {
+            const std::size_t last = std::min(child + D, n);
+            std::size_t top = child;
+            for (std::size_t j = child + 1; j < last; ++j)
+                if (less(first[top], first[j]))
+                    top = j;
+            if (!less(x, first[top]))
+                break;
+            first[i] = std::move(first[top]);
+            i = top;
+        }
+        first[i] = std::move(x);
+    }
+
+    // Replaces the top with x: the hole at the top goes down to a leaf along the larger
+    // children, then x rises from there. x usually comes from the bottom and belongs near
+    // it, so this skips most of the comparisons with x that sifting it down would make.
+    template<std::size_t D, class It, class L, class V>
+    void d_ary_replace_top(It first, std::size_t n, V&& x, L& less) {
+        std::size_t i = 0;
+        for (std::size_t child = 1; child < n; child = D * i + 1) {
+            const std::size_t last = std::min(child + D, n);
+            std::size_t top = child;
+            for (std::size_t j = child + 1; j < last; ++j)
+                top = less(first[top], first[j]) ? j : top; // a conditional move, not a branch
+            first[i] = std::move(first[top]);
+            i = top;
+        }
+        first[i] = std::forward<V>(x);
+        d_ary_sift_up<D>(first, i, less);
+    }
+
+    template<std::size_t D, class It, class L>
+    void d_ary_make_heap(It first, std::size_t n, L& less) {
+        for (std::size_t i = n > 1 ? (n - 2) / D + 1 : 0; i-- > 0; )
+            d_ary_sift_down<D>(first, n, i, less);
+    }
+} // namespace internal
+
+// A priority queue on a D-ary heap (4-ary by default), with the interface of zen::priority_queue.
+// Pushing gets cheaper and popping compares more elements per level but touches fewer cache lines.
+// Example: zen::d_ary_priority_queue<int> q(zen::ints{ 3, 9, 1 });
+template<
+    class T,
+    std::size_t D = 4,
+    class C = std::vector<T>,
+    class L = std::less<typename C::value_type>
+>
+class d_ary_priority_queue
+{
+    ZEN_STATIC_ASSERT(D >= 2, "A HEAP NEEDS AT LEAST 2 CHILDREN PER NODE");
+
+public:
+    using container_type  = C;
+    using value_compare   = L;
+    using value_type      = typename C::value_type;
+    using size_type       = typename C::size_type;
+    using reference       = typename C::reference;
+    using const_reference = typename C::const_reference;
+
+    static constexpr std::size_t arity = D;
+
+    d_ary_priority_queue() = default;
+
+    explicit d_ary_priority_queue(const L& comp) : comp(comp) {}
+
+    template<class Iterable, class = std::enable_if_t<zen::is_iterable_v<std::decay_t<Iterable>> &&
+                                                      !std::is_same_v<std::decay_t<Iterable>, d_ary_priority_queue>>>
+    d_ary_priority_queue(Iterable&& c, const L& comp = L()) : comp(comp)
+    {
+        internal::append_range(this->c, std::forward<Iterable>(c));
+        internal::d_ary_make_heap<D>(this->c.begin(), this->c.size(), this->comp);
+    }
+
+    const_reference top() const { return c.front(); }
+
+    bool      empty()    const { return c.empty(); }
+    bool      is_empty() const { return c.empty(); }
+    size_type size()     const { return c.size(); }
+
+    void push(const value_type& x) { c.push_back(x);            internal::d_ary_sift_up<D>(c.begin(), c.size() - 1, comp); }
+    void push(value_type&& x)      { c.push_back(std::move(x)); internal::d_ary_sift_up<D>(c.begin(), c.size() - 1, comp); }
+
+    template<class... Args>
+    void emplace(Args&&... args)
+    {
+        c.emplace_back(std::forward<Args>(args)...);
+        internal::d_ary_sift_up<D>(c.begin(), c.size() - 1, comp);
+    }
+
+    void pop()
+    {
+        value_type x = std::move(c.back());
+        c.pop_back();
+        if (!c.empty())
+            internal::d_ary_replace_top<D>(c.begin(), c.size(), std::move(x), comp);
+    }
+
+    template<class Iterable>
+    void push_range(Iterable&& range)
+    {
+        ZEN_STATIC_ASSERT(zen::is_iterable_v<std::decay_t<Iterable>>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+
+        const std::size_t n = c.size();
+        internal::append_range(c, std::forward<Iterable>(range));
+        if (internal::rebuild_heap_after_append(c.size(), c.size() - n)) {
+            internal::d_ary_make_heap<D>(c.begin(), c.size(), comp);
+        } else {
+            for (std::size_t i = n; i < c.size(); ++i)
+                internal::d_ary_sift_up<D>(c.begin(), i, comp);
+        }
+    }
+
+    std::vector<value_type> pop_n(std::size_t k)
+    {
+        k = std::min(k, c.size());
+        std::vector<value_type> top;
+        top.reserve(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            top.push_back(std::move(c.front()));
+            pop();
+        }
+        return top;
+    }
+
+    void swap(d_ary_priority_queue& other) noexcept(std::is_nothrow_swappable_v<C> && std::is_nothrow_swappable_v<L>)
+    {
+        using std::swap;
+        swap(c, other.c);
+        swap(comp, other.comp);
+    }
+
+protected:
+    C c;    // same names as in std::priority_queue
+    L comp;
+};
+
 } // namespace zen
\ No newline at end of file
@@ -0,0 +1,367 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <memory>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+#include "queue.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::ring_buffer
+
+// A double-ended sequence in one circular buffer whose capacity is a power of two. Popping
+// never frees memory, so a queue that has reached its working size makes no more allocations,
+// unlike std::deque that keeps allocating and freeing chunks. When full it doubles its capacity,
+// or, with Growable = false, throws std::length_error (see is_full()), so a fixed-size buffer
+// must be given its size, by the constructor or reserve(), before anything is pushed. It has what std::queue
+// needs from its container: zen::queue<T, zen::ring_buffer<T>> works.
+
+template<class T, bool Growable = true, class A = std::allocator<T>>
+class ring_buffer
+{
+    using alloc_traits = std::allocator_traits<A>;
+
+public:
+    using value_type      = T;
+    using allocator_type  = A;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+
+    // A contiguous run of elements
+    template<class U>
+    struct basic_span {
+        U*        data = nullptr;
+        size_type size = 0;
+
+        U* begin() const { return data; }
+        U* end()   const { return data + size; }
+        bool empty() const { return size == 0; }
+    };
+
+    using span       = basic_span<T>;
+    using const_span = basic_span<const T>;
+
+    template<bool Const>
+    class basic_iterator {
+        using ring = std::conditional_t<Const, const ring_buffer, ring_buffer>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+
+        basic_iterator() = default;
+        basic_iterator(ring* r, size_type i) : ring_(r), i_(i) {}
+        template<bool C = Const, class = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& it) : ring_(it.ring_), i_(it.i_) {}
+
+        reference operator*()  const { return (*ring_)[i_]; }
+        pointer   operator->() const { return &(*ring_)[i_]; }
+        reference operator[](difference_type n) const { return (*ring_)[i_ + n]; }
+
+        basic_iterator& operator++() { ++i_; return *this; }
+        basic_iterator& operator--() { --i_; return *this; }
+        basic_iterator  operator++(int) { basic_iterator it = *this; ++i_; return it; }
+        basic_iterator  operator--(int) { basic_iterator it = *this; --i_; return it; }
+
+        basic_iterator& operator+=(difference_type n) { i_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) { return difference_type(a.i_) - difference_type(b.i_); }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.i_ == b.i_; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return a.i_ != b.i_; }
+        friend bool operator< (const basic_iterator& a, const basic_iterator& b) { return a.i_ <  b.i_; }
+        friend bool operator> (const basic_iterator& a, const basic_iterator& b) { return a.i_ >  b.i_; }
+        friend bool operator<=(const basic_iterator& a, const basic_iterator& b) { return a.i_ <= b.i_; }
+        friend bool operator>=(const basic_iterator& a, const basic_iterator& b) { return a.i_ >= b.i_; }
+
+    private:
+        template<bool> friend class basic_iterator;
+
+        ring*     ring_ = nullptr;
+        size_type i_    = 0;
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    ring_buffer() = default;
+
+    explicit ring_buffer(const A& alloc) : alloc_(alloc) {}
+
+    // Room for at least capacity elements, rounded up to a power of two no less than 8,
+    // which is also the limit of a fixed-size buffer: ring_buffer<T, false>(3) holds 8
+    explicit ring_buffer(size_type capacity, const A& alloc = A()) : alloc_(alloc) { reserve(capacity); }
+
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    ring_buffer(It first, It last, const A& alloc = A()) : alloc_(alloc) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>)
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    ring_buffer(std::initializer_list<T> init, const A& alloc = A()) : ring_buffer(init.begin(), init.end(), alloc) {}
+
+    ring_buffer(const ring_buffer& other)
+        : ring_buffer(other.begin(), other.end(), alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+    ring_buffer(ring_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), capacity_(std::exchange(other.capacity_, 0)),
+          head_(std::exchange(other.head_, 0)), size_(std::exchange(other.size_, 0)), alloc_(other.alloc_) {}
+
+    ring_buffer& operator=(ring_buffer other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~ring_buffer() {
+        clear();
+        if (data_)
+            alloc_traits::deallocate(alloc_, data_, capacity_);
+    }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    iterator       begin()        { return { this, 0 }; }
+    const_iterator begin()  const { return { this, 0 }; }
+    const_iterator cbegin() const { return begin(); }
+    iterator       end()          { return { this, size_ }; }
+    const_iterator end()    const { return { this, size_ }; }
+    const_iterator cend()   const { return end(); }
+
+    T&       operator[](size_type i)       { return data_[(head_ + i) & (capacity_ - 1)]; }
+    const T& operator[](size_type i) const { return data_[(head_ + i) & (capacity_ - 1)]; }
+
+    T& at(size_type i) {
+        if (i >= size_)
+            throw std::out_of_range("RING BUFFER INDEX OUT OF RANGE");
+        return (*this)[i];
+    }
+
+    const T& at(size_type i) const { return const_cast<ring_buffer*>(this)->at(i); }
+
+    T&       front()       { return data_[head_]; }
+    const T& front() const { return data_[head_]; }
+    T&       back()        { return (*this)[size_ - 1]; }
+    const T& back()  const { return (*this)[size_ - 1]; }
+
+    bool      empty()    const noexcept { return size_ == 0; }
+    bool      is_empty() const noexcept { return size_ == 0; }
+    bool      is_full()  const noexcept { return size_ == capacity_; }
+    size_type size()     const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    // The elements in order are those of front_span() followed by those of back_span(),
+    // which is empty unless the elements wrap around the end of the buffer
+    span       front_span()       { return { data_ + head_, std::min(size_, capacity_ - head_) }; }
+    const_span front_span() const { return { data_ + head_, std::min(size_, capacity_ - head_) }; }
+    span       back_span()        { return { data_, size_ - std::min(size_, capacity_ - head_) }; }
+    const_span back_span()  const { return { data_, size_ - std::min(size_, capacity_ - head_) }; }
+
+    // Makes the capacity at least n (a power of two); this is how a fixed-size buffer gets its size
+    void reserve(size_type n) {
+        if (n > capacity_)
+            reallocate(round_up(n));
+    }
+
+    void clear() noexcept {
+        pop_front(size_);
+        head_ = 0;
+    }
+
+    void push_back(const T& x) { emplace_back(x); }
+    void push_back(T&& x)      { emplace_back(std::move(x)); }
+    void push_front(const T& x) { emplace_front(x); }
+    void push_front(T&& x)      { emplace_front(std::move(x)); }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            T x(std::forward<Args>(args)...); // args may refer to an element grow() moves away
+            grow();
+            return construct_back(std::move(x));
+        }
+        return construct_back(std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    T& emplace_front(Args&&... args) {
+        if (size_ == capacity_) {
+            T x(std::forward<Args>(args)...);
+            grow();
+            return construct_front(std::move(x));
+        }
+        return construct_front(std::forward<Args>(args)...);
+    }
+
+    void pop_front() {
+        alloc_traits::destroy(alloc_, data_ + head_);
+        head_ = (head_ + 1) & (capacity_ - 1);
+        --size_;
+    }
+
+    // Drops the n first elements at once, e.g. after processing front_span()
+    void pop_front(size_type n) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < n; ++i)
+                alloc_traits::destroy(alloc_, data_ + ((head_ + i) & (capacity_ - 1)));
+        }
+        if (n)
+            head_ = (head_ + n) & (capacity_ - 1);
+        size_ -= n;
+    }
+
+    void pop_back() {
+        --size_;
+        alloc_traits::destroy(alloc_, data_ + ((head_ + size_) & (capacity_ - 1)));
+    }
+
+    void swap(ring_buffer& other) noexcept {
+        using std::swap;
+        swap(data_, other.data_);
+        swap(capacity_, other.capacity_);
+        swap(head_, other.head_);
+        swap(size_, other.size_);
+        swap(alloc_, other.alloc_);
+    }
+
+    friend void swap(ring_buffer& a, ring_buffer& b) noexcept { a.swap(b); }
+
+    friend bool operator==(const ring_buffer& a, const ring_buffer& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+    friend bool operator!=(const ring_buffer& a, const ring_buffer& b) { return !(a == b); }
+
+private:
+    static size_type round_up(size_type n) {
+        size_type capacity = 8;
+        while (capacity < n)
+            capacity *= 2;
+        return capacity;
+    }
+
+    void grow() {
+        if constexpr (!Growable) // including one that was never given a size
+            throw std::length_error("RING BUFFER IS FULL");
+        reallocate(capacity_ ? capacity_ * 2 : 8);
+    }
+
+    template<class... Args>
+    T& construct_back(Args&&... args) {
+        T* p = data_ + ((head_ + size_) & (capacity_ - 1));
+        alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    template<class... Args>
+    T& construct_front(Args&&... args) {
+        const size_type head = (head_ - 1) & (capacity_ - 1);
+        alloc_traits::construct(alloc_, data_ + head, std::forward<Args>(args)...);
+        head_ = head;
+        ++size_;
+        return data_[head_];
+    }
+
+    // Moves the elements, in order, to the start of a new buffer
+    void reallocate(size_type capacity) {
+        T* data = alloc_traits::allocate(alloc_, capacity);
+        size_type moved = 0;
+        try {
+            for (; moved < size_; ++moved)
+                alloc_traits::construct(alloc_, data + moved, std::move_if_noexcept((*this)[moved]));
+        } catch (...) {
+            for (size_type i = 0; i < moved; ++i)
+                alloc_traits::destroy(alloc_, data + i);
+            alloc_traits::deallocate(alloc_, data, capacity);
+            throw;
+        }
+        const size_type size = size_;
+        clear();
+        if (data_)
+            alloc_traits::deallocate(alloc_, data_, capacity_);
+        data_     = data;
+        capacity_ = capacity;
+        head_     = 0;
+        size_     = size;
+    }
+
+    T*        data_     = nullptr;
+    size_type capacity_ = 0;
+    size_type head_     = 0;
+    size_type size_     = 0;
+    A         alloc_;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::ring_queue
+
+// A zen::queue on a zen::ring_buffer, with access to the buffer for bulk dequeuing
+// Example: zen::ring_queue<int> q(1024); // no allocations until it holds more than 1024
+//          for (int x : q.front_span()) ...;
+//          q.pop(q.front_span().size);
+template<class T, bool Growable = true>
+class ring_queue : public zen::queue<T, zen::ring_buffer<T, Growable>>
+{
+    using base = zen::queue<T, zen::ring_buffer<T, Growable>>;
+
+public:
+    using span       = typename zen::ring_buffer<T, Growable>::span;
+    using const_span = typename zen::ring_buffer<T, Growable>::const_span;
+
+    using base::base; // inherit constructors, has to be explicit
+    using base::pop;
+
+    ring_queue() = default;
+
+    explicit ring_queue(std::size_t capacity) { reserve(capacity); }
+
+    std::size_t capacity() const { return base::c.capacity(); }
+    bool        is_full()  const { return base::c.is_full(); }
+    void        reserve(std::size_t n) { base::c.reserve(n); }
+
+    span       front_span()       { return base::c.front_span(); }
+    const_span front_span() const { return base::c.front_span(); }
+    span       back_span()        { return base::c.back_span(); }
+    const_span back_span()  const { return base::c.back_span(); }
+
+    // Pops the n first elements at once
+    void pop(std::size_t n) { base::c.pop_front(n); }
+};
+
+} // namespace zen
@@ -0,0 +1,421 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <iterator>
+#include <array>
+#include <limits>
+#include <random>
+#include <atomic>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::rng
+
+// Small, fast pseudo-random engines. They are not cryptographically secure, but they pass the
+// usual statistical test batteries, have a few words of state instead of the 2.5 KB of a
+// std::mt19937, and satisfy UniformRandomBitGenerator, so they work with <random> distributions.
+
+namespace internal {
+    constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+
+    // Seed expander: turns any 64-bit seed (even 0) into well-mixed engine state
+    constexpr std::uint64_t splitmix64(std::uint64_t& state) noexcept {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // Full 128-bit product of two 64-bit numbers: returns the low half, stores the high one
+    inline std::uint64_t mul128(std::uint64_t a, std::uint64_t b, std::uint64_t& high) noexcept {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using uint128 = unsigned __int128; // an extension: keeps -Wpedantic quiet
+        const uint128 m = static_cast<uint128>(a) * b;
+        high = static_cast<std::uint64_t>(m >> 64);
+        return static_cast<std::uint64_t>(m);
+#else
+        const std::uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+        const std::uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+        const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+        high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+    }
+} // namespace internal
+
+// xoshiro256** by Blackman & Vigna: the general-purpose default
+class xoshiro256ss {
+public:
+    using result_type = std::uint64_t;
+
+    explicit xoshiro256ss(std::uint64_t seed = 0) noexcept { this->seed(seed); }
+
+    void seed(std::uint64_t seed) noexcept {
+        for (auto& word : s_)
+            word = internal::splitmix64(seed);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept {
+        const std::uint64_t result = internal::rotl(s_[1] * 5, 7) * 9;
+        const std::uint64_t t      = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3]  = internal::rotl(s_[3], 45);
+        return result;
+    }
+
+    // Advances the state by 2^128 steps: gives non-overlapping streams for parallel use
+    void jump() noexcept {
+        constexpr std::uint64_t polynomial[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+        std::uint64_t s[4] = {};
+        for (std::uint64_t word : polynomial) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (std::uint64_t(1) << bit)) {
+                    for (int i = 0; i < 4; ++i)
+                        s[i] ^= s_[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i)
+            s_[i] = s[i];
+    }
+
+private:
+    std::uint64_t s_[4];
+};
+
+// wyrand by Wang Yi: a single word of state and one multiplication per number
+class wyrand {
+public:
+    using result_type = std::uint64_t;
+
+    explicit wyrand(std::uint64_t seed = 0) noexcept { this->seed(seed); }
+
+    void seed(std::uint64_t seed) noexcept { state_ = internal::splitmix64(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept {
+        state_ += 0xa0761d6478bd642f;
+        std::uint64_t high;
+        const std::uint64_t low = internal::mul128(state_, state_ ^ 0xe7037ed1a0b428db, high);
+        return high ^ low;
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// PCG32 (XSH RR) by O'Neill: 32-bit output, with selectable independent streams
+class pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    explicit pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept { this->seed(seed, stream); }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0) noexcept {
+        state_ = 0;
+        inc_   = (stream << 1) | 1;
+        (*this)();
+        state_ += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept {
+        const std::uint64_t old = state_;
+        state_ = old * 6364136223846793005ULL + inc_;
+        const auto xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rot        = static_cast<std::uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+private:
+    std::uint64_t state_;
+    std::uint64_t inc_;
+};
+
+// Philox4x32-10 by Salmon et al. (Random123): a counter-based generator. Each block of four
+// 32-bit numbers is a pure function of the key (seed) and a counter, so the n-th number of a
+// stream can be computed directly, in any order and on any thread, with no state to carry.
+class philox4x32 {
+public:
+    using result_type = std::uint32_t;
+    using block_type  = std::array<std::uint32_t, 4>;
+
+    explicit philox4x32(std::uint64_t seed = 0) noexcept { this->seed(seed); }
+
+    void seed(std::uint64_t seed) noexcept { key_ = seed; counter_ = 0; index_ = 4; }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept {
+        if (index_ == 4) {
+            buffer_ = block(key_, counter_++);
+            index_  = 0;
+        }
+        return buffer_[index_++];
+    }
+
+    static block_type block(std::uint64_t key, std::uint64_t counter) noexcept {
+        std::uint32_t c0 = static_cast<std::uint32_t>(counter), c1 = static_cast<std::uint32_t>(counter >> 32), c2 = 0, c3 = 0;
+        std::uint32_t k0 = static_cast<std::uint32_t>(key),     k1 = static_cast<std::uint32_t>(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0;
+            const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c2;
+            c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            c1 = static_cast<std::uint32_t>(p1);
+            c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c3 = static_cast<std::uint32_t>(p0);
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        return { c0, c1, c2, c3 };
+    }
+
+    // The blocks for Lanes consecutive counters as 64-bit words: block k goes to out[2k] and
+    // out[2k + 1] (low and high halves). Same numbers as block(), but laid out lane by lane
+    // so that the compiler can run the rounds of all lanes in SIMD registers.
+    template<std::size_t Lanes>
+    static void blocks(std::uint64_t key, std::uint64_t counter, std::uint64_t* out) noexcept {
+        std::uint32_t c0[Lanes], c1[Lanes], c2[Lanes], c3[Lanes];
+        for (std::size_t l = 0; l < Lanes; ++l) {
+            c0[l] = static_cast<std::uint32_t>(counter + l);
+            c1[l] = static_cast<std::uint32_t>((counter + l) >> 32);
+            c2[l] = c3[l] = 0;
+        }
+        std::uint32_t k0 = static_cast<std::uint32_t>(key), k1 = static_cast<std::uint32_t>(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0[l];
+                const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c2[l];
+                c0[l] = static_cast<std::uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+                c1[l] = static_cast<std::uint32_t>(p1);
+                c2[l] = static_cast<std::uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+                c3[l] = static_cast<std::uint32_t>(p0);
+            }
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        for (std::size_t l = 0; l < Lanes; ++l) {
+            out[2 * l]     = c0[l] | (std::uint64_t(c1[l]) << 32);
+            out[2 * l + 1] = c2[l] | (std::uint64_t(c3[l]) << 32);
+        }
+    }
+
+private:
+    std::uint64_t key_;
+    std::uint64_t counter_;
+    block_type    buffer_;
+    int           index_;
+};
+
+namespace internal {
+    // A real in [0, 1) from the high bits of 64 random ones: no more bits than T keeps (24 for
+    // float, 53 at most), or the conversion to T could round the largest values up to 1
+    template<class T>
+    T unit_from_bits(std::uint64_t bits) noexcept {
+        constexpr int digits = std::numeric_limits<T>::digits < 53 ? std::numeric_limits<T>::digits : 53;
+        return static_cast<T>(bits >> (64 - digits)) / static_cast<T>(std::uint64_t(1) << digits);
+    }
+
+    // min + (max - min) * unit, kept below max when the arithmetic rounds up to it
+    template<class T>
+    T scale_unit(T unit, T min, T max) noexcept {
+        const T x = min + (max - min) * unit;
+        return !(x < max) && min < max ? std::nextafter(max, min) : x;
+    }
+
+    // Maps 64 random bits onto [min, max] (integers, by a multiply-shift whose bias is below
+    // 2^-64 relative) or [min, max) (reals), for generators where rejection would break the
+    // one-number-per-counter correspondence
+    template<class T>
+    T from_random_bits(std::uint64_t bits, T min, T max) noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            return scale_unit(unit_from_bits<T>(bits), min, max);
+        } else {
+            using U = std::make_unsigned_t<T>;
+            const std::uint64_t span = static_cast<std::uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min)));
+            std::uint64_t offset = bits;
+            if (span != std::numeric_limits<std::uint64_t>::max())
+                mul128(bits, span + 1, offset);
+            return static_cast<T>(static_cast<U>(static_cast<U>(min) + static_cast<U>(offset)));
+        }
+    }
+} // namespace internal
+
+// Draws numbers in the forms usually needed (bounded integers, reals, whole ranges)
+// from one of the engines above. Seeding with the same value gives the same sequence
+// on every platform, unlike the std distributions, whose algorithms are unspecified.
+// Example: zen::rng r(42);
+//          r.between(1, 6);      // a die roll
+//          r.uniform(0.0, 1.0);  // a real in [0, 1)
+//          r.fill(v, 10, 99);    // every element of v in [10, 99]
+template<class Engine = xoshiro256ss>
+class basic_rng {
+public:
+    using engine_type = Engine;
+    using result_type = std::uint64_t;
+
+    explicit basic_rng(std::uint64_t seed) noexcept : engine_(seed) {}
+
+    // Seeded from std::random_device
+    basic_rng() : engine_(random_seed()) {}
+
+    void seed(std::uint64_t seed) noexcept { engine_.seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    // 64 random bits
+    result_type operator()() noexcept {
+        if constexpr (sizeof(typename Engine::result_type) >= sizeof(std::uint64_t)) {
+            return engine_();
+        } else {
+            const std::uint64_t high = engine_();
+            return (high << 32) | engine_();
+        }
+    }
+
+    // A uniformly distributed integer in [0, bound), with Lemire's nearly divisionless method:
+    // one multiplication per number, and a division only in the rare case of a possible bias
+    std::uint64_t below(std::uint64_t bound) noexcept {
+        if (bound == 0)
+            return 0;
+        std::uint64_t high;
+        std::uint64_t low = internal::mul128((*this)(), bound, high);
+        if (low < bound) {
+            const std::uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold)
+                low = internal::mul128((*this)(), bound, high);
+        }
+        return high;
+    }
+
+    // A uniformly distributed integer in the closed interval [min, max]
+    template<class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    T between(T min, T max) noexcept {
+        using U = std::make_unsigned_t<T>;
+        const std::uint64_t span = static_cast<std::uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min)));
+        const std::uint64_t offset = span == std::numeric_limits<std::uint64_t>::max() ? (*this)() : below(span + 1);
+        return static_cast<T>(static_cast<U>(static_cast<U>(min) + static_cast<U>(offset)));
+    }
+
+    // A uniformly distributed real number in [min, max)
+    template<class T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    T uniform(T min = 0, T max = 1) noexcept {
+        return internal::scale_unit(internal::unit_from_bits<T>((*this)()), min, max);
+    }
+
+    // Sets every element of a range to a number in [min, max] (integers) or [min, max) (reals)
+    template<class Range, class T>
+    void fill(Range& r, T min, T max) noexcept {
+        using value_type = std::decay_t<decltype(*std::begin(r))>;
+        if constexpr (std::is_floating_point_v<value_type>) {
+            for (auto& x : r)
+                x = uniform(static_cast<value_type>(min), static_cast<value_type>(max));
+        } else {
+            for (auto& x : r)
+                x = between(static_cast<value_type>(min), static_cast<value_type>(max));
+        }
+    }
+
+    // Sets every element of a range of integers to random bits
+    template<class Range>
+    void fill(Range& r) noexcept {
+        for (auto& x : r)
+            x = static_cast<std::decay_t<decltype(x)>>((*this)());
+    }
+
+    engine_type& engine() noexcept { return engine_; }
+
+    static std::uint64_t random_seed() {
+        std::random_device rd;
+        return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+    }
+
+private:
+    Engine engine_;
+};
+
+using rng = basic_rng<>;
+
+namespace internal {
+    // 0 means "no fixed seed": each thread then seeds itself from std::random_device
+    inline std::atomic<std::uint64_t>& global_seed() {
+        static std::atomic<std::uint64_t> seed{ 0 };
+        return seed;
+    }
+
+    inline std::atomic<std::uint64_t>& thread_rng_count() {
+        static std::atomic<std::uint64_t> count{ 0 };
+        return count;
+    }
+
+    inline std::uint64_t next_thread_seed() {
+        const auto seed = global_seed().load(std::memory_order_relaxed);
+        if (seed == 0)
+            return rng::random_seed();
+        std::uint64_t mix = seed + thread_rng_count().fetch_add(1, std::memory_order_relaxed);
+        return splitmix64(mix);
+    }
+} // namespace internal
+
+// The calling thread's own generator: no locks, no sharing, no data races
+// Example: zen::thread_rng().between(1, 100);
+inline rng& thread_rng() {
+    thread_local rng r(internal::next_thread_seed());
+    return r;
+}
+
+// Makes the generators deterministic for reproducible runs. The calling thread's generator
+// restarts from this seed; threads that first use theirs afterwards get seeds derived from it
+// in the order they start. A seed of 0 goes back to seeding from std::random_device.
+// Example: zen::set_random_seed(42); // e.g. at the start of a test
+inline void set_random_seed(std::uint64_t seed) {
+    rng& r = thread_rng(); // created (if new) before the seed sequence restarts
+    internal::global_seed().store(seed, std::memory_order_relaxed);
+    internal::thread_rng_count().store(0, std::memory_order_relaxed);
+    r.seed(internal::next_thread_seed());
+}
+
+} // namespace zen
@@ -0,0 +1,430 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+#include <cmath>
+
+#include "alpha.h"    // internal; will not be included in kaizen.h
+#include "parallel.h" // internal; will not be included in kaizen.h
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ZEN_HAS_SSE2 1
+#   include <immintrin.h>
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       include <intrin.h>
+#       define ZEN_TARGET_AVX2
+#   else
+#       define ZEN_TARGET_AVX2 __attribute__((target("avx2")))
+#   endif
+#endif
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// SIMD search
+
+// Linear searches through arrays of numbers that compare 16 bytes (SSE2) or 32 bytes (AVX2,
+// picked at run time when the CPU has it) at once: 8 to 32 elements per instruction. Floating
+// point comparisons keep their usual meaning: 0.0 finds -0.0 and NaN finds nothing. Elsewhere
+// (other CPUs, other element types) the searches are plain loops.
+
+namespace internal {
+    template<class T>
+    constexpr bool is_simd_searchable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+                                     && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    inline int lowest_bit(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long i;
+        _BitScanForward(&i, mask);
+        return static_cast<int>(i);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    inline int bit_count(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return static_cast<int>(__popcnt(mask));
+#else
+        return __builtin_popcount(mask);
+#endif
+    }
+
+#if defined(ZEN_HAS_SSE2)
+    inline bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        return avx2 && osxsave && (_xgetbv(0) & 6) == 6; // the OS saves the YMM registers
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    inline bool has_avx2() {
+        static const bool avx2 = cpu_has_avx2();
+        return avx2;
+    }
+
+    // Lanes equal to x, as a byte mask (sizeof(T) bits per element)
+    template<class T>
+    std::uint32_t match_sse2(const T* p, __m128i x) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if constexpr (std::is_same_v<T, float>) {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(v), _mm_castsi128_ps(x)))));
+        } else if constexpr (std::is_same_v<T, double>) {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(v), _mm_castsi128_pd(x)))));
+        } else if constexpr (sizeof(T) == 1) {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, x)));
+        } else if constexpr (sizeof(T) == 2) {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, x)));
+        } else if constexpr (sizeof(T) == 4) {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(v, x)));
+        } else { // no 64-bit compare in SSE2: both 32-bit halves must match
+            const __m128i halves = _mm_cmpeq_epi32(v, x);
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)))));
+        }
+    }
+
+    template<class T>
+    __m128i broadcast_sse2(T x) {
+        alignas(16) T lanes[16 / sizeof(T)];
+        std::fill(std::begin(lanes), std::end(lanes), x);
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+    }
+
+    // Lanes equal to any of the k values in x, as a byte mask. Vectors are passed by pointer:
+    // passing them by value between functions with and without AVX enabled changes the ABI.
+    template<class T>
+    ZEN_TARGET_AVX2 std::uint32_t match_avx2(const T* p, const __m256i* x, std::size_t k) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i m = _mm256_setzero_si256();
+        for (std::size_t j = 0; j < k; ++j) {
+            if constexpr (std::is_same_v<T, float>) {
+                m = _mm256_or_si256(m, _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(x[j]), _CMP_EQ_OQ)));
+            } else if constexpr (std::is_same_v<T, double>) {
+                m = _mm256_or_si256(m, _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(x[j]), _CMP_EQ_OQ)));
+            } else if constexpr (sizeof(T) == 1) {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, x[j]));
+            } else if constexpr (sizeof(T) == 2) {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi16(v, x[j]));
+            } else if constexpr (sizeof(T) == 4) {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi32(v, x[j]));
+            } else {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi64(v, x[j]));
+            }
+        }
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(m));
+    }
+
+    template<class T>
+    ZEN_TARGET_AVX2 void broadcast_avx2(T value, __m256i* x) {
+        alignas(32) T lanes[32 / sizeof(T)];
+        std::fill(std::begin(lanes), std::end(lanes), value);
+        *x = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    }
+
+    // Index of the first of the n elements at p equal to any of the k values, or n.
+    // Four vectors per iteration keep several loads and compares in flight.
+    template<class T>
+    ZEN_TARGET_AVX2 std::size_t find_any_avx2(const T* p, std::size_t n, const T* values, std::size_t k) {
+        constexpr std::size_t lanes = 32 / sizeof(T);
+        __m256i x[8];
+        for (std::size_t j = 0; j < k; ++j)
+            broadcast_avx2(values[j], &x[j]);
+        std::size_t i = 0;
+        for (; i + 4 * lanes <= n; i += 4 * lanes) {
+            const std::uint32_t m0 = match_avx2(p + i, x, k),             m1 = match_avx2(p + i + lanes, x, k);
+            const std::uint32_t m2 = match_avx2(p + i + 2 * lanes, x, k), m3 = match_avx2(p + i + 3 * lanes, x, k);
+            if (m0 | m1 | m2 | m3) {
+                if (m0) return i +             lowest_bit(m0) / sizeof(T);
+                if (m1) return i +     lanes + lowest_bit(m1) / sizeof(T);
+                if (m2) return i + 2 * lanes + lowest_bit(m2) / sizeof(T);
+                return         i + 3 * lanes + lowest_bit(m3) / sizeof(T);
+            }
+        }
+        for (; i + lanes <= n; i += lanes)
+            if (const std::uint32_t m = match_avx2(p + i, x, k))
+                return i + lowest_bit(m) / sizeof(T);
+        for (; i < n; ++i)
+            for (std::size_t j = 0; j < k; ++j)
+                if (p[i] == values[j])
+                    return i;
+        return n;
+    }
+
+    template<class T>
+    ZEN_TARGET_AVX2 std::size_t count_avx2(const T* p, std::size_t n, T value) {
+        constexpr std::size_t lanes = 32 / sizeof(T);
+        __m256i x;
+        broadcast_avx2(value, &x);
+        std::size_t bits = 0, i = 0;
+        for (; i + lanes <= n; i += lanes)
+            bits += bit_count(match_avx2(p + i, &x, 1));
+        std::size_t result = bits / sizeof(T);
+        for (; i < n; ++i)
+            result += p[i] == value;
+        return result;
+    }
+
+    template<class T>
+    std::size_t find_any_sse2(const T* p, std::size_t n, const T* values, std::size_t k) {
+        constexpr std::size_t lanes = 16 / sizeof(T);
+        __m128i x[8];
+        for (std::size_t j = 0; j < k; ++j)
+            x[j] = broadcast_sse2(values[j]);
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            std::uint32_t m = 0;
+            for (std::size_t j = 0; j < k; ++j)
+                m |= match_sse2(p + i, x[j]);
+            if (m)
+                return i + lowest_bit(m) / sizeof(T);
+        }
+        for (; i < n; ++i)
+            for (std::size_t j = 0; j < k; ++j)
+                if (p[i] == values[j])
+                    return i;
+        return n;
+    }
+
+    template<class T>
+    std::size_t count_sse2(const T* p, std::size_t n, T value) {
+        constexpr std::size_t lanes = 16 / sizeof(T);
+        const __m128i x = broadcast_sse2(value);
+        std::size_t bits = 0, i = 0;
+        for (; i + lanes <= n; i += lanes)
+            bits += bit_count(match_sse2(p + i, x));
+        std::size_t result = bits / sizeof(T);
+        for (; i < n; ++i)
+            result += p[i] == value;
+        return result;
+    }
+#endif // ZEN_HAS_SSE2
+
+    // Up to this many values are searched for in a single pass
+    constexpr std::size_t simd_max_values = 8;
+
+    // Index of the first of the n elements at p equal to any of the k <= simd_max_values values, or n
+    template<class T>
+    std::size_t simd_find_any(const T* p, std::size_t n, const T* values, std::size_t k) {
+        if constexpr (is_simd_searchable<T>) {
+#if defined(ZEN_HAS_SSE2)
+            return has_avx2() ? find_any_avx2(p, n, values, k) : find_any_sse2(p, n, values, k);
+#endif
+        }
+        return static_cast<std::size_t>(std::find_if(p, p + n, [&](const T& e) {
+            return std::find(values, values + k, e) != values + k;
+        }) - p);
+    }
+
+    // Index of the first of the n elements at p equal to x, or n
+    template<class T>
+    std::size_t simd_find(const T* p, std::size_t n, const T& x) {
+        if constexpr (is_simd_searchable<T>)
+            return simd_find_any(p, n, &x, 1);
+        else
+            return static_cast<std::size_t>(std::find(p, p + n, x) - p);
+    }
+
+    // How many of the n elements at p are equal to x
+    template<class T>
+    std::size_t simd_count(const T* p, std::size_t n, const T& x) {
+        if constexpr (is_simd_searchable<T>) {
+#if defined(ZEN_HAS_SSE2)
+            return has_avx2() ? count_avx2(p, n, x) : count_sse2(p, n, x);
+#endif
+        }
+        return static_cast<std::size_t>(std::count(p, p + n, x));
+    }
+
+    // Converts v to out if some T compares equal to it, so that a search value a T can't hold
+    // (300 or -1 in bytes, 0.1 in floats) finds nothing instead of its wrapped/rounded twin
+    template<class T, class U>
+    bool representable_as(const U& v, T& out) {
+        if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<U>) {
+            if constexpr (std::is_floating_point_v<U> && std::is_integral_v<T>) {
+                // Out of range float to integer conversions are undefined: bounds are powers of two, exact in U
+                if (!(v >= static_cast<U>(std::numeric_limits<T>::lowest()) && v < std::ldexp(U(1), std::numeric_limits<T>::digits)))
+                    return false;
+            } else if constexpr (std::is_floating_point_v<U> && std::is_floating_point_v<T> && sizeof(T) < sizeof(U)) {
+                if (!std::isinf(v) && !(std::fabs(v) <= static_cast<U>(std::numeric_limits<T>::max())))
+                    return false;
+            }
+            const T t = static_cast<T>(v);
+            using C = std::common_type_t<T, U>;
+            if (static_cast<C>(t) != static_cast<C>(v) || (t < T()) != (v < U()))
+                return false;
+            out = t;
+        } else {
+            out = static_cast<T>(v);
+        }
+        return true;
+    }
+
+    // Whether any of the n elements at p is equal to any element of values (any iterable)
+    template<class T, class Values>
+    bool simd_contains_any(const T* p, std::size_t n, const Values& values) {
+        if constexpr (!is_simd_searchable<T>) {
+            return std::any_of(p, p + n, [&](const T& e) {
+                return std::find(std::begin(values), std::end(values), e) != std::end(values);
+            });
+        } else {
+            T few[simd_max_values];
+            std::size_t k = 0;
+            for (const auto& v : values) {
+                if (k == simd_max_values) { // too many for a single pass: look each element up instead
+                    std::vector<T> sorted;
+                    for (const auto& w : values) {
+                        T t;
+                        if (representable_as(w, t))
+                            sorted.push_back(t);
+                    }
+                    if constexpr (std::is_floating_point_v<T>) // NaN equals nothing and would break the ordering
+                        sorted.erase(std::remove_if(sorted.begin(), sorted.end(), [](T x) { return std::isnan(x); }), sorted.end());
+                    std::sort(sorted.begin(), sorted.end());
+                    return std::any_of(p, p + n, [&](T e) { return std::binary_search(sorted.begin(), sorted.end(), e); });
+                }
+                if (representable_as(v, few[k]))
+                    ++k;
+            }
+            return k != 0 && simd_find_any(p, n, few, k) != n;
+        }
+    }
+
+    template<class C, class T, class = void>
+    struct has_contiguous_data : std::false_type {};
+
+    template<class C, class T>
+    struct has_contiguous_data<C, T, std::void_t<decltype(std::declval<const C&>().data())>>
+        : std::is_same<decltype(std::declval<const C&>().data()), const T*> {};
+
+    // The element search methods of zen::vector, zen::array and zen::small_vector, for a Derived
+    // with begin(), end() and size(). Over a data() array of numbers they take the SIMD paths
+    // above; elsewhere (std::vector<bool> has no data()) they fall back to iterator loops.
+    template<class Derived, class T>
+    class searchable
+    {
+    public:
+        template<class Pred>
+        typename std::enable_if<std::is_invocable_r<bool, Pred, const T&>::value, bool>::type
+            contains(Pred p) const
+        {
+            return std::find_if(self().begin(), self().end(), p) != self().end();
+        }
+
+        // Numbers are compared 16 or 32 bytes at a time with SIMD instructions
+        bool contains(const T& x) const { return search(x) != self().size(); }
+
+        // Same as above, with an execution policy: under zen::exec::par, large containers are searched by several threads
+        // Example: v.contains(zen::exec::par, 42);
+        template<class Policy, class Pred>
+        typename std::enable_if<exec::is_execution_policy_v<Policy> && std::is_invocable_r<bool, Pred, const T&>::value, bool>::type
+            contains(const Policy& policy, Pred p) const
+        {
+            if constexpr (contiguous())
+                return parallel_contains(self().data(), self().size(), min_piece(policy, parallel_search_threshold), p);
+            else
+                return contains(p);
+        }
+
+        template<class Policy>
+        typename std::enable_if<exec::is_execution_policy_v<Policy>, bool>::type
+            contains(const Policy& policy, const T& x) const
+        {
+            if constexpr (contiguous()) {
+                const T* p = self().data();
+                return parallel_any(self().size(), min_piece(policy, parallel_search_threshold),
+                                    parallel_search_threshold / 4, [&](std::size_t begin, std::size_t end) {
+                    return simd_find(p + begin, end - begin, x) != end - begin;
+                });
+            } else {
+                return contains(x);
+            }
+        }
+
+        // Whether any of the given values is present
+        // Example: v.contains_any(zen::vector<int>{ 3, 5, 7 });
+        template<class Values>
+        bool contains_any(const Values& values) const
+        {
+            if constexpr (contiguous()) {
+                return simd_contains_any(self().data(), self().size(), values);
+            } else {
+                return std::any_of(self().begin(), self().end(), [&](const T& e) {
+                    return std::find(std::begin(values), std::end(values), e) != std::end(values);
+                });
+            }
+        }
+
+        bool contains_any(std::initializer_list<T> values) const { return contains_any<std::initializer_list<T>>(values); }
+
+        // Number of elements equal to x
+        std::size_t count(const T& x) const
+        {
+            if constexpr (contiguous())
+                return simd_count(self().data(), self().size(), x);
+            else
+                return static_cast<std::size_t>(std::count(self().begin(), self().end(), x));
+        }
+
+        // Position of the first element equal to x, if any
+        // Example: zen::vector<int>{ 4, 2, 4 }.index_of(2);
+        // Result: 1
+        std::optional<std::size_t> index_of(const T& x) const
+        {
+            const std::size_t i = search(x);
+            return i != self().size() ? std::optional<std::size_t>(i) : std::nullopt;
+        }
+
+    private:
+        const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+        static constexpr bool contiguous() { return has_contiguous_data<Derived, T>::value; }
+
+        std::size_t search(const T& x) const
+        {
+            if constexpr (contiguous())
+                return simd_find(self().data(), self().size(), x);
+            else
+                return static_cast<std::size_t>(std::find(self().begin(), self().end(), x) - self().begin());
+        }
+    };
+} // namespace internal
+
+} // namespace zen
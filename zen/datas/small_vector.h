@@ -0,0 +1,372 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <memory>
+
+#include "alpha.h" // internal; will not be included in kaizen.h
+#include "simd.h"  // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// zen::small_vector
+
+// A vector that keeps up to N elements inside itself and only goes to the heap past N:
+// a vector of few elements costs no allocation. Moving one that is on the heap steals its
+// buffer; moving one that is inline moves the elements. The rest works like zen::vector.
+
+template<class T, std::size_t N = 8, class A = std::allocator<T>>
+class small_vector : public internal::searchable<small_vector<T, N, A>, T>
+{
+    using alloc_traits = std::allocator_traits<A>;
+
+public:
+    using value_type             = T;
+    using allocator_type         = A;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    small_vector() noexcept(std::is_nothrow_default_constructible_v<A>) = default;
+
+    explicit small_vector(const A& alloc) noexcept : alloc_(alloc) {}
+
+    explicit small_vector(size_type n, const A& alloc = A()) : alloc_(alloc) { resize(n); }
+
+    small_vector(size_type n, const T& value, const A& alloc = A()) : alloc_(alloc) { assign(n, value); }
+
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    small_vector(It first, It last, const A& alloc = A()) : alloc_(alloc) { assign(first, last); }
+
+    small_vector(std::initializer_list<T> init, const A& alloc = A()) : alloc_(alloc) { assign(init.begin(), init.end()); }
+
+    small_vector(const small_vector& other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_))
+    {
+        assign(other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : alloc_(other.alloc_) {
+        take(std::move(other));
+    }
+
+    ~small_vector() {
+        clear();
+        release();
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(size_type n, const T& value) {
+        clear();
+        reserve(n);
+        std::uninitialized_fill_n(data_, n, value);
+        size_ = n;
+    }
+
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            reserve(n);
+            std::uninitialized_copy(first, last, data_);
+            size_ = n;
+        } else {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    iterator               begin()         noexcept { return data_; }
+    const_iterator         begin()   const noexcept { return data_; }
+    const_iterator         cbegin()  const noexcept { return data_; }
+    iterator               end()           noexcept { return data_ + size_; }
+    const_iterator         end()     const noexcept { return data_ + size_; }
+    const_iterator         cend()    const noexcept { return data_ + size_; }
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    T&       operator[](size_type i)       { return data_[i]; }
+    const T& operator[](size_type i) const { return data_[i]; }
+
+    T& at(size_type i) {
+        if (i >= size_)
+            throw std::out_of_range("SMALL_VECTOR INDEX OUT OF RANGE");
+        return data_[i];
+    }
+
+    const T& at(size_type i) const { return const_cast<small_vector*>(this)->at(i); }
+
+    T&       front()       { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T&       back()        { return data_[size_ - 1]; }
+    const T& back()  const { return data_[size_ - 1]; }
+    T*       data()        noexcept { return data_; }
+    const T* data()  const noexcept { return data_; }
+
+    bool      empty()     const noexcept { return size_ == 0; }
+    bool      is_empty()  const noexcept { return size_ == 0; }
+    size_type size()      const noexcept { return size_; }
+    size_type capacity()  const noexcept { return capacity_; }
+    size_type max_size()  const noexcept { return alloc_traits::max_size(alloc_); }
+
+    // Whether the elements are still in the inline storage
+    bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    void reserve(size_type n) {
+        if (n > capacity_)
+            reallocate(n);
+    }
+
+    // Goes back inline if the elements fit
+    void shrink_to_fit() {
+        if (!is_inline() && size_ < capacity_)
+            reallocate(size_);
+    }
+
+    void clear() noexcept {
+        std::destroy(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    void push_back(const T& x) { emplace_back(x); }
+    void push_back(T&& x)      { emplace_back(std::move(x)); }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_)
+            return grow_emplace_back(std::forward<Args>(args)...);
+        T* p = ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    void pop_back() {
+        --size_;
+        std::destroy_at(data_ + size_);
+    }
+
+    // Insertions append and rotate the new elements into place
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const difference_type i = pos - begin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+
+    iterator insert(const_iterator pos, const T& x) { return emplace(pos, x); }
+    iterator insert(const_iterator pos, T&& x)      { return emplace(pos, std::move(x)); }
+
+    iterator insert(const_iterator pos, size_type n, const T& x) {
+        const difference_type i = pos - begin();
+        const size_type old_size = size_;
+        if (size_ + n > capacity_) {
+            const T copy = x; // x may be one of the elements
+            reserve(grown(size_ + n));
+            std::uninitialized_fill_n(end(), n, copy);
+        } else {
+            std::uninitialized_fill_n(end(), n, x);
+        }
+        size_ += n;
+        std::rotate(begin() + i, begin() + difference_type(old_size), end());
+        return begin() + i;
+    }
+
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    iterator insert(const_iterator pos, It first, It last) {
+        const difference_type i = pos - begin();
+        const size_type old_size = size_;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>)
+            reserve(grown(size_ + static_cast<size_type>(std::distance(first, last))));
+        for (; first != last; ++first)
+            emplace_back(*first);
+        std::rotate(begin() + i, begin() + difference_type(old_size), end());
+        return begin() + i;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        iterator f = begin() + (first - cbegin());
+        iterator l = begin() + (last  - cbegin());
+        if (f != l) {
+            iterator new_end = std::move(l, end(), f);
+            std::destroy(new_end, end());
+            size_ -= static_cast<size_type>(l - f);
+        }
+        return f;
+    }
+
+    void resize(size_type n) {
+        if (n < size_) {
+            std::destroy(data_ + n, data_ + size_);
+        } else if (n > size_) {
+            reserve(n);
+            std::uninitialized_value_construct(data_ + size_, data_ + n);
+        }
+        size_ = n;
+    }
+
+    void resize(size_type n, const T& value) {
+        if (n <= size_)
+            resize(n);
+        else
+            insert(end(), n - size_, value);
+    }
+
+    void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+    friend bool operator!=(const small_vector& a, const small_vector& b) { return !(a == b); }
+    friend bool operator< (const small_vector& a, const small_vector& b) { return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()); }
+    friend bool operator> (const small_vector& a, const small_vector& b) { return b < a; }
+    friend bool operator<=(const small_vector& a, const small_vector& b) { return !(b < a); }
+    friend bool operator>=(const small_vector& a, const small_vector& b) { return !(a < b); }
+
+private:
+    T*       inline_data()       noexcept { return reinterpret_cast<T*>(buffer_); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(buffer_); }
+
+    size_type grown(size_type n) const { return std::max(n, 2 * capacity_); }
+
+    // Moves the elements to a buffer of capacity n >= size_: the inline one if they fit
+    void reallocate(size_type n) {
+        T* p = n <= N ? inline_data() : alloc_traits::allocate(alloc_, n);
+        if (p == data_)
+            return;
+        try {
+            std::uninitialized_move(data_, data_ + size_, p);
+        } catch (...) {
+            if (p != inline_data())
+                alloc_traits::deallocate(alloc_, p, n);
+            throw;
+        }
+        std::destroy(data_, data_ + size_);
+        release();
+        data_     = p;
+        capacity_ = std::max(n, N);
+    }
+
+    // The new element is made before the others move: args may refer to one of them
+    template<class... Args>
+    T& grow_emplace_back(Args&&... args) {
+        const size_type n = grown(size_ + 1);
+        T* p = alloc_traits::allocate(alloc_, n);
+        T* x = nullptr;
+        try {
+            x = ::new (static_cast<void*>(p + size_)) T(std::forward<Args>(args)...);
+            std::uninitialized_move(data_, data_ + size_, p);
+        } catch (...) {
+            if (x)
+                std::destroy_at(x);
+            alloc_traits::deallocate(alloc_, p, n);
+            throw;
+        }
+        std::destroy(data_, data_ + size_);
+        release();
+        data_     = p;
+        capacity_ = n;
+        ++size_;
+        return *x;
+    }
+
+    // Frees the heap buffer, if any, and goes back to the inline storage
+    void release() noexcept {
+        if (!is_inline())
+            alloc_traits::deallocate(alloc_, data_, capacity_);
+        data_     = inline_data();
+        capacity_ = N;
+    }
+
+    // Takes the elements of other, which is left empty: steals its heap buffer or moves
+    // its inline elements. Expects this to be empty and inline.
+    void take(small_vector&& other) {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.data_, other.data_ + other.size_, data_);
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_     = std::exchange(other.data_, other.inline_data());
+            size_     = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, N);
+        }
+    }
+
+    alignas(T) unsigned char buffer_[N ? N * sizeof(T) : 1];
+    T*        data_     = inline_data();
+    size_type size_     = 0;
+    size_type capacity_ = N;
+    A         alloc_;
+};
+
+} // namespace zen
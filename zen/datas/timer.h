@@ -22,8 +22,25 @@
 
 #pragma once
 
-#include <chrono>
+#include <type_traits>
 #include <functional>
+#include <utility>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <ratio>
+
+#include "histogram.h" // internal; will not be included in kaizen.h
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#   define ZEN_HAS_TSC 1
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   else
+#       include <x86intrin.h>
+#       include <cpuid.h>
+#   endif
+#endif
 
 namespace zen {
 
@@ -43,20 +60,154 @@ std::string adaptive_duration(const std::chrono::duration<Rep, Period>& d)
     return std::to_string(duration_ns) + " nanoseconds";
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////// zen::tsc_clock
+
+// A std::chrono-compatible clock that reads the CPU timestamp counter directly
+// instead of going through clock_gettime() (or QueryPerformanceCounter() on Windows),
+// which makes it cheap enough to wrap around sub-microsecond hot sections.
+// The counter is calibrated against std::chrono::steady_clock once, on first use.
+// On CPUs without an invariant TSC (whose rate may change with power states), or on
+// non-x86 targets, it falls back to std::chrono::steady_clock, so it is always safe to use.
+// Example: auto t0 = zen::tsc_clock::now(); work(); auto t1 = zen::tsc_clock::now();
+// Result:  t1 - t0 is a std::chrono::nanoseconds duration
+class tsc_clock {
+public:
+    using rep        = std::int64_t;
+    using period     = std::nano;
+    using duration   = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<tsc_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept { return from_ticks(ticks()); }
+
+    // Same as now(), but waits for all previous instructions to retire
+    // before reading the counter, so it's what a timer uses on stop()
+    static time_point now_ordered() noexcept { return from_ticks(ticks_ordered()); }
+
+    // True if the TSC is actually used; false if steady_clock is used instead
+    static bool is_invariant() noexcept { return calibration().invariant; }
+
+    // Calibrated counter frequency (0 if the steady_clock fallback is used)
+    static double ticks_per_second() noexcept {
+        return is_invariant() ? 1e9 / calibration().ns_per_tick : 0;
+    }
+
+    // Raw counter value. Falls back to steady_clock nanoseconds without an invariant TSC.
+    static std::uint64_t ticks() noexcept {
+#if defined(ZEN_HAS_TSC)
+        if (calibration().invariant)
+            return __rdtsc();
+#endif
+        return steady_ns();
+    }
+
+    static std::uint64_t ticks_ordered() noexcept {
+#if defined(ZEN_HAS_TSC)
+        if (calibration().invariant) {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return steady_ns();
+    }
+
+private:
+    struct calibration_data {
+        bool          invariant   = false;
+        double        ns_per_tick = 1.0;
+        std::uint64_t base_ticks  = 0; // counter value at calibration time
+        std::uint64_t base_ns     = 0; // steady_clock time at calibration time
+    };
+
+    static std::uint64_t steady_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<duration>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static time_point from_ticks(std::uint64_t t) noexcept {
+        const auto& cal = calibration();
+        if (!cal.invariant)
+            return time_point(duration(static_cast<rep>(t)));
+
+        // Offsetting by the base keeps the double multiplication exact enough
+        // (53 bits of mantissa cover months of ticks at nanosecond resolution)
+        const auto ns = static_cast<double>(static_cast<std::int64_t>(t - cal.base_ticks)) * cal.ns_per_tick;
+        return time_point(duration(static_cast<rep>(cal.base_ns) + static_cast<rep>(ns)));
+    }
+
+    static bool detect_invariant_tsc() noexcept {
+#if defined(ZEN_HAS_TSC)
+        // CPUID leaf 0x80000007, EDX bit 8: the TSC runs at a constant rate
+        // regardless of frequency scaling and keeps ticking in deep C-states
+        unsigned int regs[4] = {};
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned int>(info[0]) < 0x80000007) return false;
+        __cpuid(info, 0x80000007);
+        regs[3] = static_cast<unsigned int>(info[3]);
+    #else
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+        __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+    #endif
+        return (regs[3] & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    static calibration_data calibrate() noexcept {
+        calibration_data cal;
+#if defined(ZEN_HAS_TSC)
+        if (!detect_invariant_tsc())
+            return cal;
+
+        // Spin for a few milliseconds and compare how far both clocks moved
+        using namespace std::chrono;
+        const auto t0 = steady_clock::now();
+        const auto c0 = __rdtsc();
+        auto t1 = t0;
+        while (t1 - t0 < milliseconds(5))
+            t1 = steady_clock::now();
+        const auto c1 = __rdtsc();
+
+        if (c1 <= c0)
+            return cal;
+
+        cal.invariant   = true;
+        cal.ns_per_tick = static_cast<double>(duration_cast<nanoseconds>(t1 - t0).count()) / static_cast<double>(c1 - c0);
+        cal.base_ticks  = c1;
+        cal.base_ns     = static_cast<std::uint64_t>(duration_cast<nanoseconds>(t1.time_since_epoch()).count());
+#endif
+        return cal;
+    }
+
+    static const calibration_data& calibration() noexcept {
+        static const calibration_data cal = calibrate(); // once, thread-safe
+        return cal;
+    }
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////// zen::timer
 
-class timer {
+// The clock is a policy so that hot paths can trade the portable clock for
+// the cheaper zen::tsc_clock without changing any of the timer code around it.
+// Example: zen::timer     t; // std::chrono::high_resolution_clock
+// Example: zen::tsc_timer t; // zen::tsc_clock, falls back to steady_clock
+template<class Clock = std::chrono::high_resolution_clock>
+class basic_timer {
 public:
-    timer() : start_(std::chrono::high_resolution_clock::now()), 
-               stop_(std::chrono::high_resolution_clock::now())
-    {}
+    using clock = Clock;
 
-    auto start() { start_ = std::chrono::high_resolution_clock::now(); return *this; }
-    auto stop()  {  stop_ = std::chrono::high_resolution_clock::now(); return *this; }
+    basic_timer() : start_(Clock::now()), stop_(start_) {}
+
+    auto start() { start_ = Clock::now(); return *this; }
+    auto stop()  {  stop_ = stop_now();   return *this; }
 
     template<class Duration>
     auto elapsed() const {
-        const auto now = std::chrono::high_resolution_clock::now();
+        const auto now = Clock::now();
         return std::chrono::duration_cast<Duration>(now - start_);
     }
 
@@ -69,6 +220,12 @@ public:
         return adaptive_duration(duration<nsec>());
     }
 
+    // Example: zen::histogram h; for (...) { zen::timer t; work(); t.stop().record_into(h); }
+    void record_into(zen::histogram& h) const { h.record(duration<nsec>()); }
+
+    auto started_at() const { return start_; }
+    auto stopped_at() const { return  stop_; }
+
     using nsec = std::chrono::nanoseconds;
     using usec = std::chrono::microseconds;
     using msec = std::chrono::milliseconds;
@@ -81,17 +238,74 @@ public:
   //using y    = std::chrono::years;  // since C++20
 
 private:
-    std::chrono::time_point<std::chrono::high_resolution_clock> start_;
-    std::chrono::time_point<std::chrono::high_resolution_clock>  stop_;
+    static auto stop_now() {
+        if constexpr (std::is_same_v<Clock, tsc_clock>)
+            return Clock::now_ordered();
+        else
+            return Clock::now();
+    }
+
+    typename Clock::time_point start_;
+    typename Clock::time_point  stop_;
 };
 
-template<typename Duration = timer::nsec>
-auto measure_execution(std::function<void()> operation)
+using timer     = basic_timer<>;
+using tsc_timer = basic_timer<tsc_clock>;
+
+// Times a single run of any invocable (lambda, function pointer, functor). Taking the
+// callable as a template parameter rather than an std::function avoids both a possible
+// heap allocation of its captures and an indirect call inside the measured region.
+// Example: auto d = zen::measure_execution([&]{ work(); });
+// Result:  std::chrono::nanoseconds (or the Duration given as template argument)
+template<class Duration = timer::nsec, class Operation>
+auto measure_execution(Operation&& operation)
 {
     timer t;
-    operation();
+    std::invoke(std::forward<Operation>(operation));
     t.stop();
     return t.duration<Duration>();
 }
 
+// Runs the operation the given number of times in a tight loop and returns the average
+// duration of a single run. Timing a batch amortizes the cost of reading the clock, which
+// otherwise dominates operations of a few nanoseconds. The result is a floating-point
+// duration so that runs shorter than one tick of Duration don't round down to zero.
+// Example: auto d = zen::measure_execution([&]{ zen::do_not_optimize(x = hash(x)); }, 1'000'000);
+// Result:  std::chrono::duration<double, std::nano> like 4.8ns
+template<class Duration = timer::nsec, class Operation>
+auto measure_execution(Operation&& operation, std::size_t iterations)
+{
+    timer t;
+    for (std::size_t i = 0; i < iterations; ++i)
+        std::invoke(operation);
+    t.stop();
+
+    using average = std::chrono::duration<double, typename Duration::period>;
+    return std::chrono::duration_cast<average>(t.duration<timer::nsec>()) / static_cast<double>(iterations ? iterations : 1);
+}
+
+// Like measure_execution(), but also hands back what the operation returned.
+// Example: auto [result, d] = zen::measure_result([&]{ return parse(text); });
+template<class Duration = timer::nsec, class Operation>
+auto measure_result(Operation&& operation)
+{
+    timer t;
+    auto result = std::invoke(std::forward<Operation>(operation));
+    t.stop();
+    return std::pair<decltype(result), Duration>(std::move(result), t.duration<Duration>());
+}
+
+// Keeps the compiler from optimizing away a value that is computed only to be measured
+// Example: zen::measure_execution([&]{ zen::do_not_optimize(std::sqrt(x)); }, 1000);
+template<class T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*reinterpret_cast<const volatile char*>(&value)); // forces value into memory
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
 } // namespace zen
\ No newline at end of file
@@ -27,26 +27,18 @@
 #include <vector>
 
 #include "alpha.h" // internal; will not be included in kaizen.h
+#include "simd.h"  // internal; will not be included in kaizen.h
 
 namespace zen {
 
 ///////////////////////////////////////////////////////////////////////////////////////////// zen::vector
 
 template<class T, class A = std::allocator<T>>
-class vector : public std::vector<T, A>, private zen::stackonly
+class vector : public std::vector<T, A>, public internal::searchable<vector<T, A>, T>, private zen::stackonly
 {
 public:
     using std::vector<T, A>::vector; // inherit constructors, has to be explicit
 
-    template<class Pred>
-    typename std::enable_if<std::is_invocable_r<bool, Pred, const T&>::value, bool>::type
-        contains(Pred p) const
-    {
-        return std::find_if(my::begin(), my::end(), p) != my::end();
-    }
-
-    bool contains(const T& x) const { return std::find(my::begin(), my::end(), x) != my::end(); }
-    
     bool is_empty() const { return my::empty(); }
 
 private:
@@ -0,0 +1,166 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <type_traits>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <tuple>
+
+#include "../datas/logger.h" // internal; will not be included in kaizen.h
+#include "utils.h"           // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// log_deferred
+
+// Structured logging with deferred formatting. While zen::logger is running, the calling thread
+// only copies the raw bytes of the arguments (numbers, strings, containers of those) into a binary
+// record along with the address of the format string, which serves as the id of the call site.
+// The writer thread formats the record later. Each {} in the format takes the next argument,
+// {{ and }} stand for literal braces, and any arguments without a {} are appended, space-separated.
+// Arguments of other types are formatted right away through zen::to_string().
+// Without a running logger, it formats and logs the line immediately, just like zen::log().
+// Example: zen::log_deferred("order {} filled at {} in {}ns", id, price, latency);
+// Result:  order 42 filled at 101.25 in 380ns
+namespace internal {
+    template<class T, class = void>
+    struct is_deferrable : std::bool_constant<std::is_arithmetic_v<T> || is_string_like<T>()> {};
+
+    // Containers qualify if their elements do
+    template<class T>
+    struct is_deferrable<T, std::enable_if_t<!std::is_arithmetic_v<T> && !is_string_like<T>() && is_iterable_v<T>>>
+        : is_deferrable<std::decay_t<decltype(*std::begin(std::declval<const T&>()))>> {};
+
+    // What an argument looks like after it has been through the binary record
+    template<class T, class = void> struct decoded { using type = std::string_view; };
+    template<class T> struct decoded<T, std::enable_if_t<std::is_arithmetic_v<T>>> { using type = T; };
+    template<class T> struct decoded<T, std::enable_if_t<!std::is_arithmetic_v<T> && !is_string_like<T>() && is_deferrable<T>::value>> {
+        using type = std::vector<typename decoded<std::decay_t<decltype(*std::begin(std::declval<const T&>()))>>::type>;
+    };
+    template<class T> using decoded_t = typename decoded<T>::type;
+
+    // Non-deferrable arguments are turned into strings up front
+    template<class T>
+    decltype(auto) deferrable(const T& x) {
+        if constexpr (is_deferrable<T>::value) return (x);
+        else                                   return std::string(zen::to_string(x));
+    }
+
+    template<class T>
+    std::size_t encoded_size(const T& x) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return sizeof(T);
+        } else if constexpr (is_string_like<T>()) {
+            return sizeof(std::uint32_t) + std::string_view(x).size();
+        } else {
+            std::size_t n = sizeof(std::uint32_t);
+            for (const auto& e : x)
+                n += encoded_size(e);
+            return n;
+        }
+    }
+
+    template<class T>
+    void encode(char*& at, const T& x) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            std::memcpy(at, &x, sizeof(T));
+            at += sizeof(T);
+        } else if constexpr (is_string_like<T>()) {
+            const std::string_view sv(x);
+            const auto n = static_cast<std::uint32_t>(sv.size());
+            std::memcpy(at, &n, sizeof(n));
+            std::memcpy(at + sizeof(n), sv.data(), n);
+            at += sizeof(n) + n;
+        } else {
+            const auto n = static_cast<std::uint32_t>(std::distance(std::begin(x), std::end(x)));
+            std::memcpy(at, &n, sizeof(n));
+            at += sizeof(n);
+            for (const auto& e : x)
+                encode(at, e);
+        }
+    }
+
+    template<class T>
+    decoded_t<T> decode(const char*& at) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            T x;
+            std::memcpy(&x, at, sizeof(T));
+            at += sizeof(T);
+            return x;
+        } else {
+            std::uint32_t n;
+            std::memcpy(&n, at, sizeof(n));
+            at += sizeof(n);
+            if constexpr (is_string_like<T>()) {
+                const std::string_view sv(at, n);
+                at += n;
+                return sv;
+            } else {
+                decoded_t<T> v;
+                v.reserve(n);
+                for (std::uint32_t i = 0; i < n; ++i)
+                    v.push_back(decode<std::decay_t<decltype(*std::begin(std::declval<const T&>()))>>(at));
+                return v;
+            }
+        }
+    }
+
+    // Instantiated once per combination of argument types; the record stores its address
+    template<class... Ts>
+    void decode_record(std::string& out, const char* at, std::size_t) {
+        const char* fmt;
+        std::memcpy(&fmt, at, sizeof(fmt));
+        at += sizeof(fmt);
+        const std::tuple<decoded_t<Ts>...> values{ decode<Ts>(at)... }; // braces: left to right
+        std::apply([&](const auto&... v) { format_into(out, fmt, v...); }, values);
+    }
+
+    template<class... Ts>
+    bool submit_deferred(const char* fmt, const Ts&... values) {
+        const std::size_t size = sizeof(fmt) + (encoded_size(values) + ... + 0);
+        return zen::logger::submit_deferred(&decode_record<Ts...>, size, [&](char* at) {
+            std::memcpy(at, &fmt, sizeof(fmt));
+            at += sizeof(fmt);
+            (encode(at, values), ...);
+        });
+    }
+} // namespace internal
+
+// The format must be a string literal: its address is what identifies the call site
+template<std::size_t N, class... Args>
+void log_deferred(const char (&fmt)[N], const Args&... args)
+{
+    if (zen::logger::is_running()) {
+        if (internal::submit_deferred(fmt, internal::deferrable(args)...) || zen::logger::is_running())
+            return; // queued, or dropped by zen::overflow_policy::drop
+    }
+    std::string line;
+    internal::format_into(line, fmt, args...);
+    log_line(std::move(line));
+}
+
+} // namespace zen
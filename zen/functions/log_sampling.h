@@ -0,0 +1,121 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+#include "../datas/timer.h" // internal; will not be included in kaizen.h
+#include "utils.h"          // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// log levels & sampling
+
+// Severity of a log record. Records below the global threshold are discarded before formatting.
+enum class log_level { trace, debug, info, warning, error, fatal, off };
+
+namespace internal {
+    inline std::atomic<log_level>& log_threshold() {
+        static std::atomic<log_level> threshold{ log_level::trace };
+        return threshold;
+    }
+
+    // The state of a single ZEN_LOG_EVERY_N / ZEN_LOG_FIRST_N / ZEN_LOG_EVERY_MS call site.
+    // Each macro expansion owns a static one, so call sites never share their counters.
+    class log_site {
+    public:
+        // True on the 1st, (n+1)th, (2n+1)th... call
+        bool every_n(std::uint64_t n) noexcept {
+            return n != 0 && count_.fetch_add(1, std::memory_order_relaxed) % n == 0;
+        }
+
+        // True on the first n calls; after that, a single relaxed load per call
+        bool first_n(std::uint64_t n) noexcept {
+            return count_.load(std::memory_order_relaxed) < n
+                && count_.fetch_add(1, std::memory_order_relaxed) < n;
+        }
+
+        // True at most once per interval; exactly one of the threads racing for a slot wins it
+        bool every(std::chrono::nanoseconds interval) noexcept {
+            const auto now  = zen::tsc_clock::now().time_since_epoch().count();
+            auto       next = next_.load(std::memory_order_relaxed);
+            return now >= next
+                && next_.compare_exchange_strong(next, now + interval.count(), std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<std::uint64_t> count_{ 0 };
+        std::atomic<std::int64_t>  next_{ std::numeric_limits<std::int64_t>::min() };
+    };
+} // namespace internal
+
+// Sets the least severe level that still gets logged by zen::log_if() and ZEN_LOG_IF.
+// Example: zen::set_log_level(zen::log_level::warning); // drops trace, debug and info
+inline void set_log_level(log_level level) {
+    internal::log_threshold().store(level, std::memory_order_relaxed);
+}
+
+inline log_level get_log_level() {
+    return internal::log_threshold().load(std::memory_order_relaxed);
+}
+
+inline bool is_log_enabled(log_level level) {
+    return level != log_level::off && level >= get_log_level();
+}
+
+// Logs like zen::log(), but only if the level passes the threshold. The arguments
+// themselves are still evaluated by the caller; use ZEN_LOG_IF to skip that too.
+// Example: zen::log_if(zen::log_level::debug, "queue depth:", q.size());
+template<class... Args>
+void log_if(log_level level, Args&&... args) {
+    if (is_log_enabled(level))
+        zen::log(std::forward<Args>(args)...);
+}
+
+} // namespace zen
+
+// The macros below evaluate their log arguments only when a record is actually
+// emitted, so they can stay in hot loops without paying for the formatting.
+
+// Example: ZEN_LOG_IF(zen::log_level::debug, "state:", expensive_dump());
+#define ZEN_LOG_IF(level, ...) \
+    do { if (zen::is_log_enabled(level)) zen::log(__VA_ARGS__); } while (0)
+
+// Logs on the 1st, (n+1)th, (2n+1)th... pass through this line.
+// Example: for (auto& x : v) ZEN_LOG_EVERY_N(1000, "processing", x);
+#define ZEN_LOG_EVERY_N(n, ...) \
+    do { static zen::internal::log_site zen_log_site_; if (zen_log_site_.every_n(n)) zen::log(__VA_ARGS__); } while (0)
+
+// Logs only on the first n passes through this line.
+// Example: ZEN_LOG_FIRST_N(3, "cache miss for key", key);
+#define ZEN_LOG_FIRST_N(n, ...) \
+    do { static zen::internal::log_site zen_log_site_; if (zen_log_site_.first_n(n)) zen::log(__VA_ARGS__); } while (0)
+
+// Logs at most once every ms milliseconds from this line, whichever thread gets there first.
+// Example: ZEN_LOG_EVERY_MS(500, "progress:", done, "/", total);
+#define ZEN_LOG_EVERY_MS(ms, ...) \
+    do { static zen::internal::log_site zen_log_site_; \
+         if (zen_log_site_.every(std::chrono::milliseconds(ms))) zen::log(__VA_ARGS__); } while (0)
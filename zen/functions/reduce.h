@@ -0,0 +1,402 @@
+// MIT License
+// 
+// Copyright (c) 2023 Leo Heinsaar
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <type_traits>
+#include <stdexcept>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include "../datas/parallel.h" // internal; will not be included in kaizen.h
+#include "utils.h"             // internal; will not be included in kaizen.h
+
+namespace zen {
+
+///////////////////////////////////////////////////////////////////////////////////////////// REDUCTIONS
+//
+// sum(), min(), max(), minmax(), mean(), variance() and dot() over any iterable. Contiguous
+// containers of numbers (std::vector, std::array, zen::vector, zen::reals, C arrays...) take
+// a fast path: the loops keep several independent accumulators so that the compiler can
+// keep them in SIMD registers, and inputs of more than a few hundred thousand elements are
+// split across threads, whose partial results are then combined.
+
+// How floating-point numbers get added up. Rounding errors of a plain running sum grow
+// linearly with the number of elements, those of a pairwise sum only logarithmically, and a
+// Kahan (compensated) sum keeps them constant, at about four times the cost of the others.
+enum class summation {
+    pairwise, // sums halves recursively; the default: nearly as fast as it gets, and accurate
+    kahan,    // compensated summation: the most accurate, the slowest
+    fast      // independent running sums, reassociated freely
+};
+
+namespace internal {
+    template<class Iterable>
+    using element_t = std::decay_t<decltype(*std::begin(std::declval<const Iterable&>()))>;
+
+    // True for containers whose elements are plain numbers laid out contiguously in memory
+    template<class Iterable>
+    constexpr bool is_contiguous_arithmetic() {
+        if constexpr (is_contiguous<const Iterable>::value) {
+            using T = element_t<Iterable>;
+            return std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+        } else {
+            return false;
+        }
+    }
+
+    constexpr std::size_t reduce_lanes              = 8;       // independent accumulators
+    constexpr std::size_t pairwise_block            = 128;     // pairwise sums recurse down to this
+    constexpr std::size_t parallel_reduce_threshold = 1 << 18; // elements per thread, at least
+
+    // Plain sum of term(i) over [begin, end) in reduce_lanes independent accumulators
+    template<class T, class Term>
+    T sum_lanes(std::size_t begin, std::size_t end, Term& term) {
+        if (end - begin < reduce_lanes) {
+            T s{};
+            for (std::size_t i = begin; i < end; ++i)
+                s += term(i);
+            return s;
+        }
+        T acc[reduce_lanes] = {};
+        std::size_t i = begin;
+        for (; i + reduce_lanes <= end; i += reduce_lanes)
+            for (std::size_t l = 0; l < reduce_lanes; ++l)
+                acc[l] += term(i + l);
+        for (std::size_t l = 0; i < end; ++i, ++l)
+            acc[l] += term(i);
+        for (std::size_t half = reduce_lanes / 2; half > 0; half /= 2) // pairwise across the lanes too
+            for (std::size_t l = 0; l < half; ++l)
+                acc[l] += acc[l + half];
+        return acc[0];
+    }
+
+    template<class T, class Term>
+    T sum_pairwise(std::size_t begin, std::size_t end, Term& term) {
+        if (end - begin <= pairwise_block)
+            return sum_lanes<T>(begin, end, term);
+        const std::size_t middle = begin + (end - begin) / 2;
+        return sum_pairwise<T>(begin, middle, term) + sum_pairwise<T>(middle, end, term);
+    }
+
+    // Kahan summation, lane by lane, then over the lanes and their compensations
+    template<class T, class Term>
+    T sum_kahan(std::size_t begin, std::size_t end, Term& term) {
+        T acc[reduce_lanes] = {}, comp[reduce_lanes] = {}; // comp: what's been lost, negated
+        auto add = [](T& s, T& c, T x) {
+            const T y = x - c;
+            const T t = s + y;
+            c = (t - s) - y;
+            s = t;
+        };
+        std::size_t i = begin;
+        for (; i + reduce_lanes <= end; i += reduce_lanes)
+            for (std::size_t l = 0; l < reduce_lanes; ++l)
+                add(acc[l], comp[l], term(i + l));
+        for (std::size_t l = 0; i < end; ++i, ++l)
+            add(acc[l], comp[l], term(i));
+        T s{}, c{};
+        for (std::size_t l = 0; l < reduce_lanes; ++l) {
+            add(s, c, acc[l]);
+            add(s, c, -comp[l]);
+        }
+        return s - c;
+    }
+
+    // Sums term(i) over [0, n) the way requested, in parallel for large n
+    template<class T, class Term>
+    T sum_terms(std::size_t n, Term term, summation how, std::size_t min_piece = parallel_reduce_threshold) {
+        auto piece = [&](std::size_t begin, std::size_t end) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (how == summation::kahan)    return sum_kahan<T>(begin, end, term);
+                if (how == summation::pairwise) return sum_pairwise<T>(begin, end, term);
+            }
+            return sum_lanes<T>(begin, end, term);
+        };
+        if (n / 2 < min_piece)
+            return piece(std::size_t{0}, n);
+        return parallel_reduce<T>(n, min_piece, piece, [](T a, T b) { return a + b; });
+    }
+
+    // Smallest and largest element of a contiguous range, lane by lane
+    template<class T>
+    std::pair<T, T> minmax_lanes(const T* p, std::size_t begin, std::size_t end) {
+        T lo[reduce_lanes], hi[reduce_lanes];
+        for (std::size_t l = 0; l < reduce_lanes; ++l)
+            lo[l] = hi[l] = p[begin];
+        std::size_t i = begin;
+        for (; i + reduce_lanes <= end; i += reduce_lanes) {
+            for (std::size_t l = 0; l < reduce_lanes; ++l) {
+                lo[l] = p[i + l] < lo[l] ? p[i + l] : lo[l];
+                hi[l] = hi[l] < p[i + l] ? p[i + l] : hi[l];
+            }
+        }
+        for (; i < end; ++i) {
+            lo[0] = p[i] < lo[0] ? p[i] : lo[0];
+            hi[0] = hi[0] < p[i] ? p[i] : hi[0];
+        }
+        for (std::size_t l = 1; l < reduce_lanes; ++l) {
+            lo[0] = lo[l] < lo[0] ? lo[l] : lo[0];
+            hi[0] = hi[0] < hi[l] ? hi[l] : hi[0];
+        }
+        return { lo[0], hi[0] };
+    }
+
+    template<class Iterable>
+    std::size_t size_of(const Iterable& c) {
+        return static_cast<std::size_t>(std::distance(std::begin(c), std::end(c)));
+    }
+
+    template<class Iterable>
+    void expect_not_empty(const Iterable& c, const char* function) {
+        if (std::begin(c) == std::end(c))
+            throw std::invalid_argument(std::string(function) + " EXPECTS A NON-EMPTY RANGE");
+    }
+} // namespace internal
+
+// Adds up all elements, starting from the first one (not from 0), so that any
+// Addable type works: numbers, but also points, complex numbers, matrices, etc.
+// Contiguous containers of numbers are summed with SIMD-friendly loops and, if large
+// and the policy allows it, in parallel; floating-point ones pairwise (see zen::summation).
+// That reorders the additions, so from 8 elements on a floating-point result can differ
+// in the last bits from a plain left-to-right loop (usually for the better).
+// Empty ones give T{}.
+// Example: zen::sum(zen::exec::seq, zen::vector<int>{1, 2, 3})
+// Result:  6
+template<class Policy, class Iterable, std::enable_if_t<exec::is_execution_policy_v<Policy>, int> = 0>
+auto sum(const Policy& policy, const Iterable& c)
+{
+    ZEN_STATIC_ASSERT(is_iterable_v<Iterable>,         "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+    ZEN_STATIC_ASSERT(is_addable_v<decltype(*std::begin(c))>, "ELEMENT TYPE EXPECTED TO BE Addable, BUT IS NOT");
+
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        using T = internal::element_t<Iterable>;
+        const T* p = std::data(c);
+        return internal::sum_terms<T>(internal::size_of(c), [p](std::size_t i) { return p[i]; }, summation::pairwise,
+                                      internal::min_piece(policy, internal::parallel_reduce_threshold));
+    } else {
+        if (std::begin(c) == std::end(c)) {
+            return decltype(*std::begin(c)){}; // zero-initialized value for empty containers
+        }
+
+        // By initializing 'sum' to the first element of the collection and not just the tempting 0,
+        // this function makes fewer assumptions about the type it's working with, thereby making
+        // this function more robust and generic since we're dealing with arbitrary addable types
+        // (which could be complex numbers, matrices, etc.).
+        auto sum = *std::begin(c);
+        for (auto it = std::next(std::begin(c)); it != std::end(c); ++it) {
+            sum += *it;
+        }
+
+        return sum;
+    }
+}
+
+// Same, under zen::exec::par: contiguous inputs of 512K elements or more (2 pieces of
+// internal::parallel_reduce_threshold) are summed on several threads. Pass zen::exec::seq
+// to stay on the calling thread.
+// Example: zen::sum(zen::vector<int>{1, 2, 3})
+// Result:  6
+template<class Iterable>
+auto sum(const Iterable& c)
+{
+    return sum(exec::par, c);
+}
+
+// Same, with a choice of how floating-point numbers are added up
+// Example: zen::sum(zen::exec::seq, readings, zen::summation::kahan);
+template<class Policy, class Iterable, std::enable_if_t<exec::is_execution_policy_v<Policy>, int> = 0>
+auto sum(const Policy& policy, const Iterable& c, summation how)
+{
+    using T = internal::element_t<Iterable>;
+    ZEN_STATIC_ASSERT(std::is_floating_point_v<T>, "ELEMENT TYPE EXPECTED TO BE FLOATING-POINT, BUT IS NOT");
+
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        const T* p = std::data(c);
+        return internal::sum_terms<T>(internal::size_of(c), [p](std::size_t i) { return p[i]; }, how,
+                                      internal::min_piece(policy, internal::parallel_reduce_threshold));
+    } else {
+        // Not random-access: sum through an intermediate contiguous copy
+        const std::vector<T> v(std::begin(c), std::end(c));
+        return sum(policy, v, how);
+    }
+}
+
+// Example: zen::sum(readings, zen::summation::kahan);
+template<class Iterable>
+auto sum(const Iterable& c, summation how)
+{
+    return sum(exec::par, c, how);
+}
+
+// Smallest and largest element at once. Throws std::invalid_argument if c is empty.
+// Example: auto [lo, hi] = zen::minmax(v);
+template<class Iterable>
+auto minmax(const Iterable& c)
+{
+    ZEN_STATIC_ASSERT(is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+    internal::expect_not_empty(c, "zen::minmax");
+
+    using T = internal::element_t<Iterable>;
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        const T* p = std::data(c);
+        const std::size_t n = internal::size_of(c);
+        if (n / 2 < internal::parallel_reduce_threshold)
+            return internal::minmax_lanes(p, 0, n);
+        return internal::parallel_reduce<std::pair<T, T>>(n, internal::parallel_reduce_threshold,
+            [p](std::size_t begin, std::size_t end) { return internal::minmax_lanes(p, begin, end); },
+            [](const std::pair<T, T>& a, const std::pair<T, T>& b) {
+                return std::pair<T, T>(b.first < a.first ? b.first : a.first, a.second < b.second ? b.second : a.second);
+            });
+    } else {
+        std::pair<T, T> result(*std::begin(c), *std::begin(c));
+        for (const auto& x : c) {
+            if (x < result.first)  result.first  = x;
+            if (result.second < x) result.second = x;
+        }
+        return result;
+    }
+}
+
+// Smallest element. Throws std::invalid_argument if c is empty.
+// Example: zen::min(std::vector{3, 1, 2})
+// Result:  1
+template<class Iterable>
+auto min(const Iterable& c)
+{
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        return minmax(c).first;
+    } else {
+        ZEN_STATIC_ASSERT(is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+        internal::expect_not_empty(c, "zen::min");
+        auto result = *std::begin(c);
+        for (const auto& x : c)
+            if (x < result) result = x;
+        return result;
+    }
+}
+
+// Largest element. Throws std::invalid_argument if c is empty.
+// Example: zen::max(std::vector{3, 1, 2})
+// Result:  3
+template<class Iterable>
+auto max(const Iterable& c)
+{
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        return minmax(c).second;
+    } else {
+        ZEN_STATIC_ASSERT(is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+        internal::expect_not_empty(c, "zen::max");
+        auto result = *std::begin(c);
+        for (const auto& x : c)
+            if (result < x) result = x;
+        return result;
+    }
+}
+
+// Arithmetic mean of numbers, as a double (or long double). Throws std::invalid_argument if c is empty.
+// Example: zen::mean(std::vector{1, 2, 3, 4})
+// Result:  2.5
+template<class Iterable>
+auto mean(const Iterable& c)
+{
+    using T = internal::element_t<Iterable>;
+    using R = std::common_type_t<T, double>;
+    ZEN_STATIC_ASSERT(std::is_arithmetic_v<T>, "ELEMENT TYPE EXPECTED TO BE ARITHMETIC, BUT IS NOT");
+    internal::expect_not_empty(c, "zen::mean");
+
+    const std::size_t n = internal::size_of(c);
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        const T* p = std::data(c);
+        return internal::sum_terms<R>(n, [p](std::size_t i) { return static_cast<R>(p[i]); }, summation::pairwise) / static_cast<R>(n);
+    } else {
+        R s{};
+        for (const auto& x : c)
+            s += static_cast<R>(x);
+        return s / static_cast<R>(n);
+    }
+}
+
+// Variance of numbers: the population variance, or with sample = true, the unbiased sample
+// variance (divided by n - 1). Computed in two passes, around the mean, which avoids the
+// catastrophic cancellation of the one-pass sum-of-squares formula.
+// Throws std::invalid_argument if c has fewer elements than needed (1, or 2 for samples).
+// Example: zen::variance(std::vector{1.0, 2.0, 3.0, 4.0})
+// Result:  1.25
+template<class Iterable>
+auto variance(const Iterable& c, bool sample = false)
+{
+    using T = internal::element_t<Iterable>;
+    using R = std::common_type_t<T, double>;
+    ZEN_STATIC_ASSERT(std::is_arithmetic_v<T>, "ELEMENT TYPE EXPECTED TO BE ARITHMETIC, BUT IS NOT");
+
+    const std::size_t n = internal::size_of(c);
+    if (n < (sample ? 2u : 1u))
+        throw std::invalid_argument("zen::variance EXPECTS AT LEAST " + std::string(sample ? "2 ELEMENTS" : "1 ELEMENT"));
+
+    const R m = mean(c);
+    R squares{};
+    if constexpr (internal::is_contiguous_arithmetic<Iterable>()) {
+        const T* p = std::data(c);
+        squares = internal::sum_terms<R>(n, [p, m](std::size_t i) { const R d = static_cast<R>(p[i]) - m; return d * d; }, summation::pairwise);
+    } else {
+        for (const auto& x : c) {
+            const R d = static_cast<R>(x) - m;
+            squares += d * d;
+        }
+    }
+    return squares / static_cast<R>(sample ? n - 1 : n);
+}
+
+// Inner product of two equally long sequences of numbers.
+// Throws std::invalid_argument if their lengths differ.
+// Example: zen::dot(std::vector{1, 2, 3}, std::vector{4, 5, 6})
+// Result:  32
+template<class Iterable1, class Iterable2>
+auto dot(const Iterable1& a, const Iterable2& b)
+{
+    using T1 = internal::element_t<Iterable1>;
+    using T2 = internal::element_t<Iterable2>;
+    using R  = decltype(std::declval<T1>() * std::declval<T2>());
+    ZEN_STATIC_ASSERT(std::is_arithmetic_v<T1> && std::is_arithmetic_v<T2>, "ELEMENT TYPES EXPECTED TO BE ARITHMETIC, BUT ARE NOT");
+
+    const std::size_t n = internal::size_of(a);
+    if (n != internal::size_of(b))
+        throw std::invalid_argument("zen::dot EXPECTS RANGES OF EQUAL LENGTH");
+
+    if constexpr (internal::is_contiguous_arithmetic<Iterable1>() && internal::is_contiguous_arithmetic<Iterable2>()) {
+        const T1* p = std::data(a);
+        const T2* q = std::data(b);
+        return internal::sum_terms<R>(n, [p, q](std::size_t i) { return p[i] * q[i]; }, summation::pairwise);
+    } else {
+        R s{};
+        auto it = std::begin(b);
+        for (const auto& x : a)
+            s += x * *it++;
+        return s;
+    }
+}
+
+} // namespace zen
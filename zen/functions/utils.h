@@ -23,6 +23,10 @@
 #pragma once
 
 #include <string_view>
+#include <type_traits>
+#include <charconv>
+#include <cstdio>
+#include <stdexcept>
 #include <filesystem>
 #include <iostream>
 #include <optional>
@@ -31,6 +35,9 @@
 #include <atomic>
 #include <ctime>
 
+#include "../datas/parallel.h" // internal; will not be included in kaizen.h
+#include "../datas/rng.h"      // internal; will not be included in kaizen.h
+
 namespace zen {
 
 ///////////////////////////////////////////////////////////////////////////////////////////// USEFUL MISC
@@ -62,60 +69,164 @@ zen::string repeat(const int n, const std::string_view s) {
 ///////////////////////////////////////////////////////////////////////////////////////////// MAIN UTILITIES
 
 // Example: random_int();
-// Result: A random integer between [min, max)
+// Result: A random integer between [min, max]
+// Each thread draws from its own zen::thread_rng(), so this is safe to call from many threads
+// at once and doesn't contend on a shared engine; zen::set_random_seed() makes it reproducible.
 template<class T = int>
 T random_int(const T min = 0, const T max = 10) {
-    // Reasons why the std::random_device and the std::mt19937 are 'static' below:
-    // ---------------------------------------------------------------------------------------------------------------
-    // 1. Initialization Efficiency:
-    // Random devices and generators often involve some computational cost due to entropy gathering, seeding, generator
-    // initialization and good old algorithmic complexity. By declaring them as static, they are initialized only once,
-    // the first time the function is called. Subsequent calls to to this function reuse the existing instances, avoiding the overhead.
-    // ---------------------------------------------------------------------------------------------------------------
-    // 2. State Preservation:
-    // Random number generators like std::mt19937 maintain an internal state that evolves as numbers are generated.
-    // This state determines the sequence of random numbers produced. By making the std::mt19937 object static,
-    // the state is preserved across calls to this function, ensuring a proper random sequence. If the std::mt19937
-    // object were reinitialized on every call, it might lead to repeated or patterned sequences, undermining the randomness.
-    // ---------------------------------------------------------------------------------------------------------------
-    // 3. Thread Safety Considerations:
-    // Declaring these variables as static within a function means they are shared across all calls to that function
-    // within the program, regardless of where it's called from. This could potentially raise thread-safety issues if the
-    // function is called simultaneously from multiple threads. However, in most common usage scenarios where thread
-    // safety is not a concern, using static variables for this purpose is fine.
-    // ---------------------------------------------------------------------------------------------------------------
-    // 4. Resource Management
-    // Since the std::random_device and the std::mt19937 object are static, they are not destroyed when the function returns,
-    // but rather when the program ends. This ensures that the same random device and generator instances are reused
-    // throughout the lifetime of the program, optimizing resource management.
-    // ---------------------------------------------------------------------------------------------------------------
-    // 5. Avoiding Repetition
-    // If we didn't make these objects static, and the random number generator was reseeded with the same or similar
-    // seeds (which might happen if the function is called in quick succession), you might get the same or similar random
-    // numbers in different calls. Making these static ensures a more varied and truly random sequence.
-    // ---------------------------------------------------------------------------------------------------------------
-    // The 'static' below is for reasons outlined above.
-    static std::random_device        rd;
-    static std::mt19937              gen(rd());
-    std::uniform_int_distribution<T> dis(min, max);
-    return dis(gen);
+    return zen::thread_rng().between(min, max);
+}
+
+namespace internal {
+    template<class C, class = void>
+    struct is_contiguous : std::false_type {};
+    template<class C>
+    struct is_contiguous<C, std::void_t<decltype(std::data(std::declval<C&>()))>> : std::true_type {};
+
+    // Sets element i of [begin, end) to map(the i-th 64 bits of the Philox stream for the seed).
+    // Elements depend on their index only, so pieces of a range can be filled independently.
+    template<class It, class Map>
+    void philox_fill(It out, std::size_t begin, std::size_t end, std::uint64_t seed, Map& map) {
+        auto half = [](const philox4x32::block_type& b, std::size_t i) {
+            return i % 2 == 0 ? b[0] | (std::uint64_t(b[1]) << 32)
+                              : b[2] | (std::uint64_t(b[3]) << 32);
+        };
+        std::size_t i = begin;
+        if (i < end && i % 2 == 1) {
+            *out++ = map(half(philox4x32::block(seed, i / 2), i));
+            ++i;
+        }
+        constexpr std::size_t lanes = 8;
+        for (std::uint64_t bits[2 * lanes]; i + 2 * lanes <= end; i += 2 * lanes) {
+            philox4x32::blocks<lanes>(seed, i / 2, bits);
+            for (auto b : bits)
+                *out++ = map(b);
+        }
+        for (; i + 1 < end; i += 2) {
+            const auto b = philox4x32::block(seed, i / 2);
+            *out++ = map(half(b, 0));
+            *out++ = map(half(b, 1));
+        }
+        if (i < end)
+            *out = map(half(philox4x32::block(seed, i / 2), i));
+    }
+
+    // Below this many elements, a fill isn't worth starting threads for
+    constexpr std::size_t parallel_random_threshold = 1 << 16;
+
+    template<class Iterable, class Map>
+    void fill_random_bits(Iterable& c, std::uint64_t seed, Map map, std::size_t min_piece) {
+        const auto n = static_cast<std::size_t>(std::distance(std::begin(c), std::end(c)));
+        if constexpr (is_contiguous<Iterable>::value) {
+            auto* data = std::data(c);
+            parallel_pieces(n, min_piece, [&](std::size_t begin, std::size_t end) {
+                philox_fill(data + begin, begin, end, seed, map);
+            });
+        } else {
+            philox_fill(std::begin(c), 0, n, seed, map);
+        }
+    }
+
+    // For arbitrary distributions (which consume a varying amount of random bits), the range is
+    // cut into fixed-size chunks, each with its own engine seeded from the Philox stream,
+    // so that the result doesn't depend on how many threads did the work.
+    template<class Iterable, class Distribution>
+    void fill_distribution(Iterable& c, const Distribution& dist, std::uint64_t seed, std::size_t min_piece) {
+        constexpr std::size_t chunk = 4096;
+        const auto n      = static_cast<std::size_t>(std::distance(std::begin(c), std::end(c)));
+        const auto chunks = (n + chunk - 1) / chunk;
+
+        auto fill_chunks = [&](auto out, std::size_t first, std::size_t last) {
+            for (std::size_t k = first; k < last; ++k) {
+                const auto b = philox4x32::block(seed, k);
+                zen::rng r(b[0] | (std::uint64_t(b[1]) << 32));
+                Distribution d = dist;
+                for (std::size_t i = k * chunk; i < std::min(n, (k + 1) * chunk); ++i)
+                    *out++ = d(r);
+            }
+        };
+
+        if constexpr (is_contiguous<Iterable>::value) {
+            auto* data = std::data(c);
+            parallel_pieces(chunks, std::max<std::size_t>(1, min_piece / chunk), [&](std::size_t first, std::size_t last) {
+                fill_chunks(data + first * chunk, first, last);
+            });
+        } else {
+            fill_chunks(std::begin(c), 0, chunks);
+        }
+    }
+
+    template<class Iterable>
+    void resize_if_empty(Iterable& c, std::size_t size) {
+        if constexpr (is_resizable_v<Iterable>) {
+            if (std::empty(c))
+                c.resize(size);
+        }
+    }
+} // namespace internal
+
+// Fills a container with random numbers in [min, max] (integers) or [min, max) (reals).
+// Numbers come from the counter-based Philox generator: the same seed gives the same
+// contents, and under a parallel policy large contiguous containers are filled by several
+// threads at once, with the same result. An empty resizable container is first resized to 10 elements.
+// Example: std::vector<double> v(1'000'000);
+//          zen::generate_random(zen::exec::par, v, -1.0, 1.0, 42);
+// Result: A million reals in [-1, 1), the same on every run
+template<class Policy, class Iterable, class T,
+         std::enable_if_t<exec::is_execution_policy_v<Policy> && std::is_arithmetic_v<T>, int> = 0>
+void generate_random(const Policy& policy, Iterable& c, T min, T max, std::uint64_t seed = zen::thread_rng()())
+{
+    ZEN_STATIC_ASSERT(zen::is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+
+    using value_type = std::decay_t<decltype(*std::begin(c))>;
+    internal::resize_if_empty(c, 10);
+    internal::fill_random_bits(c, seed, [min, max](std::uint64_t bits) {
+        return static_cast<value_type>(internal::from_random_bits(bits, min, max));
+    }, internal::min_piece(policy, internal::parallel_random_threshold));
 }
 
 // Very often all we want is a dead simple way of quickly
 // generating a container filled with some random numbers.
+// Any container works, as with the overloads above; size only applies to an empty resizable one.
 // Example: std::vector<int> v;
 //          zen::generate_random(v);
-// Result: A vector of size 10 with random integers between [min, max)
+// Result: A vector of size 10 with random integers between [10, 99]
 template<class Iterable>
-void generate_random(Iterable& c, int size = 10) // TODO: Generalize & test with all containers before Kaizen 1.0.0 release
+void generate_random(Iterable& c, int size = 10)
 {
-    ZEN_STATIC_ASSERT(zen::is_iterable_v< Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
-    ZEN_STATIC_ASSERT(zen::is_resizable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
+    ZEN_STATIC_ASSERT(zen::is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
 
-    if (std::empty(c))
-        c.resize(size);
+    internal::resize_if_empty(c, static_cast<std::size_t>(size));
+    if (!std::empty(c)) // or the overload would resize it to its own default
+        zen::generate_random(exec::par, c, 10, 99);
+}
+
+// Same, under zen::exec::par
+// Example: zen::generate_random(v, 1, 6, 42);
+template<class Iterable, class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+void generate_random(Iterable& c, T min, T max, std::uint64_t seed = zen::thread_rng()())
+{
+    generate_random(exec::par, c, min, max, seed);
+}
+
+// Fills a container with numbers drawn from any <random>-style distribution, reproducibly per seed
+// Example: zen::generate_random(zen::exec::seq, v, std::normal_distribution<double>(0.0, 1.0), 42);
+template<class Policy, class Iterable, class Distribution, class = typename Distribution::result_type,
+         std::enable_if_t<exec::is_execution_policy_v<Policy>, int> = 0>
+void generate_random(const Policy& policy, Iterable& c, const Distribution& dist, std::uint64_t seed = zen::thread_rng()())
+{
+    ZEN_STATIC_ASSERT(zen::is_iterable_v<Iterable>, "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
 
-    std::generate(std::begin(c), std::end(c), [&]() { return random_int(10, 99); });
+    internal::resize_if_empty(c, 10);
+    internal::fill_distribution(c, dist, seed, internal::min_piece(policy, internal::parallel_random_threshold));
+}
+
+// Same, under zen::exec::par
+// Example: zen::generate_random(v, std::normal_distribution<double>(0.0, 1.0), 42);
+template<class Iterable, class Distribution, class = typename Distribution::result_type>
+void generate_random(Iterable& c, const Distribution& dist, std::uint64_t seed = zen::thread_rng()())
+{
+    generate_random(exec::par, c, dist, seed);
 }
 
 // Over the years it has become clear that the standard member
@@ -129,30 +240,6 @@ bool is_empty(const HasEmpty& c)
     return c.empty();
 }
 
-// TODO: Think of a way to use the Addable concept in addition
-// to Iterable that will not make the resulting code too ugly.
-template<class Iterable>
-auto sum(const Iterable& c)
-{
-    ZEN_STATIC_ASSERT(is_iterable_v<Iterable>,         "TEMPLATE PARAMETER EXPECTED TO BE Iterable, BUT IS NOT");
-    ZEN_STATIC_ASSERT(is_addable_v<decltype(*std::begin(c))>, "ELEMENT TYPE EXPECTED TO BE Addable, BUT IS NOT");
-
-    if (c.empty()) {
-        return decltype(*std::begin(c)){}; // zero-initialized value for empty containers
-    }
-
-    // By initializing 'sum' to the first element of the collection and not just the tempting 0,
-    // this function makes fewer assumptions about the type it's working with, thereby making
-    // this function more robust and generic since we're dealing with arbitrary addable types
-    // (which could be complex numbers, matrices, etc.).
-    auto sum = *std::begin(c);
-    for (auto it = std::next(std::begin(c)); it != std::end(c); ++it) {
-        sum += *it;
-    }
-
-    return sum;
-}
-
 ///////////////////////////////////////////////////////////////////////////////////////////// LPS (Log, Print, String)
 // 
 // Printing and logging in Kaizen follows the LPS principle of textual visualization.
@@ -163,82 +250,300 @@ auto sum(const Iterable& c)
 
 // ------------------------------------------------------------------------------------------ stringify
 
-// Converts most of the widely used data types to a string.
-// Example: std::vector<int> v = {1, 3, 3};
-// Example: to_string(vec) Result: [1, 2, 3]
-// Example: to_string(42)  Result: "42"
+namespace internal {
+    template<class C, class = void> struct has_std_size : std::false_type {};
+    template<class C> struct has_std_size<C, std::void_t<decltype(std::size(std::declval<const C&>()))>> : std::true_type {};
+
+    template<class C, class = void> struct has_random_access : std::false_type {};
+    template<class C> struct has_random_access<C, std::void_t<decltype(std::end(std::declval<const C&>()) - std::begin(std::declval<const C&>()))>> : std::true_type {};
+
+    // A rough upper bound of the characters a value formats to. Containers are estimated
+    // from their first element, so even deeply nested ones are sized in O(depth) steps.
+    // Only containers that know their size (or have random-access iterators) are counted;
+    // walking a list or a set just to reserve would cost more than it saves.
+    template<class T>
+    std::size_t estimated_length(const T& x) {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+            return 1;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return std::is_floating_point_v<T> ? 12 : 8;
+        } else if constexpr (is_string_like<T>()) {
+            if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                return std::string_view(x).size();
+            else
+                return 16;
+        } else if constexpr (is_iterable_v<T>) {
+            const auto it = std::begin(x);
+            if (it == std::end(x))
+                return 2;
+            std::size_t n = 4; // unknown without walking it
+            if constexpr (has_std_size<T>::value)
+                n = static_cast<std::size_t>(std::size(x));
+            else if constexpr (has_random_access<T>::value)
+                n = static_cast<std::size_t>(std::end(x) - it);
+            return 2 + n * (estimated_length(*it) + 2);
+        } else {
+            return 16;
+        }
+    }
+
+    template<class T>
+    void append_number(std::string& out, T x) {
+        char buf[64]; // enough for any integer and for %g of any floating-point value
+        if constexpr (std::is_integral_v<T>) {
+            out.append(buf, std::to_chars(buf, buf + sizeof(buf), x).ptr);
+        } else {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            // Precision 6 in general format is exactly what std::ostream prints by default
+            out.append(buf, std::to_chars(buf, buf + sizeof(buf), x, std::chars_format::general, 6).ptr);
+#else
+            const int n = std::is_same_v<T, long double> ? std::snprintf(buf, sizeof(buf), "%Lg", x)
+                                                         : std::snprintf(buf, sizeof(buf), "%g", static_cast<double>(x));
+            out.append(buf, static_cast<std::size_t>(n));
+#endif
+        }
+    }
+} // namespace internal
+
+// Appends the textual form of x to 'out', the way to_string(x) would return it. This is the
+// formatting core of the LPS functions: numbers go through std::to_chars, strings are appended
+// directly and containers are written element by element into the same buffer, so formatting
+// a big nested container costs no more than the growth of the one string. Only types without
+// a fast path (anything with just an operator<<) still go through a std::ostringstream.
+// Example: std::string s = "v = ";
+//          zen::to_string_into(s, std::vector{1, 2, 3});
+// Result:  "v = [1, 2, 3]"
 template<class T>
-zen::string to_string(const T& x) {
-    std::stringstream ss;
-    
+void to_string_into(std::string& out, const T& x) {
     // First check for string-likeness so that zen::pring("abc") prints "abc"
     // and not [a, b, c] as a result of considering strings as iterable below
     if constexpr (is_string_like<T>()) {
-        return x;
+        if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            out += std::string_view(x);
+        else
+            out += std::string(x);
+    } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+        out += static_cast<char>(x);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        out += x ? '1' : '0'; // like std::ostream without std::boolalpha
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        internal::append_number(out, x);
     } else if constexpr (is_iterable_v<T>) {
-        ss << "[";
+        out += '[';
         auto it = std::begin(x);
         if (it != std::end(x)) {
-            ss << to_string(*it++);       // recursive call to handle nested iterables
+            to_string_into(out, *it++);   // recursive call to handle nested iterables
         }
         for (; it != std::end(x); ++it) {
-            ss << ", " << to_string(*it); // recursive call to handle nested iterables
+            out += ", ";
+            to_string_into(out, *it);     // recursive call to handle nested iterables
         }
-        ss << "]";
-    } else { // not iterable, single item
+        out += ']';
+    } else { // not iterable, single item without a fast path
+        std::ostringstream ss;
         ss << x;
+        out += ss.str();
     }
-    return ss.str();
 }
 
-// Recursive variadic template to handle multiple arguments
+// Converts most of the widely used data types to a string.
+// Example: std::vector<int> v = {1, 3, 3};
+// Example: to_string(vec) Result: [1, 2, 3]
+// Example: to_string(42)  Result: "42"
+template<class T>
+zen::string to_string(const T& x) {
+    std::string s;
+    s.reserve(internal::estimated_length(x));
+    to_string_into(s, x);
+    return s;
+}
+
+// Several items are separated by spaces and formatted into a single buffer
+// Example: to_string(v, "mixed", 42) Result: "[1, 2, 3] mixed 42"
 template<class T, class... Args>
 inline zen::string to_string(const T& x, const Args&... args) {
-    return to_string(x) + " " + to_string(args...);
+    std::string s;
+    s.reserve(internal::estimated_length(x) + (... + (1 + internal::estimated_length(args))));
+    to_string_into(s, x);
+    ((s += ' ', to_string_into(s, args)), ...);
+    return s;
 }
-// Base case for the recursive calls
+// Base case for the variadic calls
 inline zen::string to_string() { return ""; }
 
-// ------------------------------------------------------------------------------------------ print
+// Same as to_string(x), but under a parallel policy, the elements of a large random-access
+// container are formatted by several threads, each into a piece of its own, and then joined.
+// Example: zen::to_string(zen::exec::par, big_vector);
+template<class Policy, class T, std::enable_if_t<exec::is_execution_policy_v<Policy>, int> = 0>
+zen::string to_string(const Policy& policy, const T& x) {
+    if constexpr (is_iterable_v<T> && !is_string_like<T>()) {
+        using iterator = decltype(std::begin(x));
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<iterator>::iterator_category>) {
+            const auto first     = std::begin(x);
+            const auto n         = static_cast<std::size_t>(std::end(x) - first);
+            const auto min_size  = internal::min_piece(policy, internal::parallel_format_threshold);
+            const auto pieces    = internal::piece_count(n, min_size);
+            if (pieces > 1) {
+                std::vector<std::string> parts(pieces);
+                internal::parallel_indexed_pieces(n, min_size, [&](std::size_t p, std::size_t begin, std::size_t end) {
+                    auto& out = parts[p];
+                    out.reserve((end - begin) * (internal::estimated_length(first[begin]) + 2));
+                    for (std::size_t i = begin; i < end; ++i) {
+                        if (i != begin)
+                            out += ", ";
+                        to_string_into(out, first[i]);
+                    }
+                });
+                std::size_t length = 2;
+                for (const auto& part : parts)
+                    length += part.size() + 2;
+                std::string s;
+                s.reserve(length);
+                s += '[';
+                for (std::size_t p = 0; p < pieces; ++p) {
+                    if (p != 0)
+                        s += ", ";
+                    s += parts[p];
+                }
+                s += ']';
+                return s;
+            }
+        }
+    }
+    return to_string(x);
+}
 
-// Function to handle individual item printing
-template <class T>
-void print(const T& x)
-{
-    std::cout << to_string(x);
+// ------------------------------------------------------------------------------------------ format
+
+namespace internal {
+    // Counts the {} placeholders of a format, skipping the escaped {{ and }}
+    constexpr std::size_t count_placeholders(std::string_view fmt) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i + 1 < fmt.size(); ++i) {
+            if ((fmt[i] == '{' || fmt[i] == '}') && fmt[i + 1] == fmt[i]) {
+                ++i;
+            } else if (fmt[i] == '{' && fmt[i + 1] == '}') {
+                ++n;
+                ++i;
+            }
+        }
+        return n;
+    }
+
+    // No arguments left: the rest is literal, with {{ and }} still unescaped
+    inline void format_arg(std::string& out, std::string_view fmt, std::size_t& pos) {
+        for (; pos < fmt.size(); ++pos) {
+            out += fmt[pos];
+            if ((fmt[pos] == '{' || fmt[pos] == '}') && pos + 1 < fmt.size() && fmt[pos + 1] == fmt[pos])
+                ++pos;
+        }
+    }
+
+    // Appends the format up to the next {} (unescaping {{ and }}), then the argument
+    template<class T>
+    void format_arg(std::string& out, std::string_view fmt, std::size_t& pos, const T& x) {
+        while (pos < fmt.size()) {
+            const char c = fmt[pos];
+            if ((c == '{' || c == '}') && pos + 1 < fmt.size() && fmt[pos + 1] == c) {
+                out += c;
+                pos += 2;
+            } else if (c == '{' && pos + 1 < fmt.size() && fmt[pos + 1] == '}') {
+                pos += 2;
+                zen::to_string_into(out, x);
+                return;
+            } else {
+                out += c;
+                ++pos;
+            }
+        }
+        out += ' '; // more arguments than {}s
+        zen::to_string_into(out, x);
+    }
+
+    template<class... Args>
+    void format_into(std::string& out, std::string_view fmt, const Args&... args) {
+        std::size_t pos = 0;
+        (format_arg(out, fmt, pos, args), ...);
+        format_arg(out, fmt, pos);
+    }
+
+    template<class T> struct type_identity { using type = T; };
+    template<class T> using type_identity_t = typename type_identity<T>::type;
+} // namespace internal
+
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#   define ZEN_CONSTEVAL consteval
+#else
+#   define ZEN_CONSTEVAL constexpr
+#endif
+
+// A format string literal whose {} placeholders are counted against the arguments
+// when the program is compiled. A mismatch fails to compile, pointing at the throw
+// below (on compilers without consteval, the check throws std::invalid_argument).
+template<class... Args>
+class format_string {
+public:
+    template<std::size_t N>
+    ZEN_CONSTEVAL format_string(const char (&s)[N]) : str_(s, N - 1) {
+        if (internal::count_placeholders(str_) != sizeof...(Args))
+            throw std::invalid_argument("FORMAT PLACEHOLDER COUNT DOES NOT MATCH THE NUMBER OF ARGUMENTS");
+    }
+
+    constexpr std::string_view get() const { return str_; }
+
+private:
+    std::string_view str_;
+};
+
+// Replaces each {} with the next argument, formatted as by to_string(); {{ and }} are literal braces.
+// Example: zen::format("{} scored {} of {}", "Ann", 42, std::vector{1, 2});
+// Result:  "Ann scored 42 of [1, 2]"
+template<class... Args>
+zen::string format(format_string<internal::type_identity_t<Args>...> fmt, const Args&... args) {
+    std::string s;
+    s.reserve(fmt.get().size() + (std::size_t{0} + ... + internal::estimated_length(args)));
+    internal::format_into(s, fmt.get(), args...);
+    return s;
 }
 
+// ------------------------------------------------------------------------------------------ print
+
 // Generic, almost Python-like print(). Works like this:
 // print("Hello", "World", vec, 42); // Output: Hello World [1, 2, 3] 42
 // print("Hello", "World", 24, vec); // Output: Hello World 24 [1, 2, 3]
 // print("Hello", vec, 42, "World"); // Output: Hello [1, 2, 3] 42 World
-template <class T, class... Args>
-void print(T x, Args... args) {
-    print(x);
+// Arguments are taken by reference, so printing a big container never copies it,
+// and the whole line reaches std::cout in a single write.
+template <class... Args>
+void print(Args&&... args)
+{
     if constexpr (sizeof...(args) != 0) {
-        std::cout << " ";
+        std::cout << to_string(args...);
     }
-    print(args...);
 }
-// Base case for the recursive calls
-inline void print() {}
 
 // ------------------------------------------------------------------------------------------ log
 
-// Handles logging a single item
-template <class T>
-void log(const T& x)
+// Writes a complete line at once: either straight to std::cout (flushed, like std::endl),
+// or, while zen::logger is running, through its asynchronous writer thread. Either way,
+// lines logged concurrently from several threads never get mixed up mid-line.
+inline void log_line(std::string line)
 {
-    print(x, '\n');
+    if (zen::logger::is_running()) {
+        if (zen::logger::submit(line) || zen::logger::is_running())
+            return; // queued, or dropped by zen::overflow_policy::drop
+    }
+    line += '\n';
+    std::cout << line << std::flush;
 }
 
-// Generic, almost Python-like log(). Works similar to the print() function but adds std::endl
-template <class T, class... Args>
-void log(T x, Args... args) {
-    print(x, args...);
-    std::cout << std::endl;
+// Generic, almost Python-like log(). Works similar to the print() function but adds a new line
+template <class... Args>
+void log(Args&&... args)
+{
+    if constexpr (sizeof...(args) != 0) {
+        log_line(to_string(args...));
+    }
 }
-// Base case for the recursive calls
-inline void log() {}
 
 } // namespace zen
\ No newline at end of file